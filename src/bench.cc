@@ -0,0 +1,619 @@
+#include "ob/buffer.hh"
+#include "ob/color.hh"
+#include "ob/grid.hh"
+#include "ob/random.hh"
+#include "ob/rect.hh"
+#include "ob/readline.hh"
+#include "ob/string.hh"
+#include "ob/text.hh"
+
+#include "peaclock/peaclock.hh"
+#include "peaclock/tui.hh"
+
+#include <ctime>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include <new>
+#include <array>
+#include <regex>
+#include <string>
+#include <fstream>
+#include <optional>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <stdexcept>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+// heap allocations since program start
+static std::size_t allocs {0};
+
+void* operator new(std::size_t size)
+{
+  ++allocs;
+
+  if (auto ptr = std::malloc(size ? size : 1))
+  {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace
+{
+
+struct Ctx
+{
+  // minimum time spent measuring each case
+  std::chrono::milliseconds time {50};
+
+  // only run benchmarks whose name contains this string
+  std::string filter;
+
+  // seed of the random colours, fixed so runs are reproducible
+  std::uint64_t seed {1};
+
+  // fixed timestamp the clock renders from, advanced by one second per frame
+  std::time_t epoch {1546300800};
+
+  // config file parsed by the config load benchmark
+  std::string config {BENCH_CONFIG};
+
+  std::vector<std::string> results;
+} ctx;
+
+struct Size
+{
+  std::size_t width;
+  std::size_t height;
+};
+
+std::array<Size, 5> const sizes {{
+  {80, 24},
+  {120, 40},
+  {200, 60},
+  {300, 90},
+  {500, 150},
+}};
+
+std::array<std::pair<char const*, Peaclock::Mode::Type>, 4> const modes {{
+  {"date", Peaclock::Mode::date},
+  {"digital", Peaclock::Mode::digital},
+  {"binary", Peaclock::Mode::binary},
+  {"icon", Peaclock::Mode::icon},
+}};
+
+// static colours are drawn as given, rainbow steps once per frame,
+// party steps once per block or grapheme
+std::array<char const*, 3> const colors {{
+  "static",
+  "rainbow",
+  "party",
+}};
+
+std::string color_key(std::string const& mode, std::string const& key)
+{
+  return mode == "static" ? key : mode;
+}
+
+std::string json_str(std::string const& str)
+{
+  std::string res {"\""};
+
+  for (auto const c : str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      res += '\\';
+    }
+
+    res += c;
+  }
+
+  return res + "\"";
+}
+
+// run fn in doubling batches until the minimum time has passed,
+// fn returns the number of output bytes it produced
+template<typename F>
+void measure(std::string const& bench, std::string const& params, F&& fn)
+{
+  if (! ctx.filter.empty() && bench.find(ctx.filter) == std::string::npos)
+  {
+    return;
+  }
+
+  // warm up caches and lazily built state
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    fn();
+  }
+
+  std::size_t iterations {0};
+  std::size_t bytes {0};
+  auto const allocs_begin = allocs;
+  auto const time_begin = std::chrono::steady_clock::now();
+  std::chrono::nanoseconds elapsed {0};
+
+  for (std::size_t batch = 1;; batch *= 2)
+  {
+    for (std::size_t i = 0; i < batch; ++i)
+    {
+      bytes += fn();
+    }
+
+    iterations += batch;
+    elapsed = std::chrono::steady_clock::now() - time_begin;
+
+    if (elapsed >= ctx.time)
+    {
+      break;
+    }
+  }
+
+  auto const per = [&](double const val) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << val / static_cast<double>(iterations);
+
+    return os.str();
+  };
+
+  ctx.results.emplace_back(
+    "{\"bench\":" + json_str(bench) +
+    (params.empty() ? "" : "," + params) +
+    ",\"iterations\":" + std::to_string(iterations) +
+    ",\"ns_per_frame\":" + per(static_cast<double>(elapsed.count())) +
+    ",\"bytes_per_frame\":" + per(static_cast<double>(bytes)) +
+    ",\"allocs_per_frame\":" + per(static_cast<double>(allocs - allocs_begin)) +
+    "}");
+
+  std::cerr << "." << std::flush;
+}
+
+std::string params_size(Size const& size)
+{
+  return "\"width\":" + std::to_string(size.width) +
+    ",\"height\":" + std::to_string(size.height);
+}
+
+void bench_render()
+{
+  for (auto const& size : sizes)
+  {
+    for (auto const& [mode_name, mode] : modes)
+    {
+      for (auto const seconds : {false, true})
+      {
+        for (std::string const color : colors)
+        {
+          Peaclock clock;
+          clock.cfg.mode = mode;
+          clock.cfg.seconds = seconds;
+          clock.cfg.style.active_bg = OB::Color(color_key(color, "blue"), OB::Color::Type::bg);
+          clock.cfg.style.inactive_bg = OB::Color(color_key(color, "236"), OB::Color::Type::bg);
+          clock.cfg.style.date = OB::Color(color_key(color, "yellow"), OB::Color::Type::fg);
+          clock.cfg_changed();
+
+          OB::Grid grid;
+          OB::Buffer buf;
+          auto time = ctx.epoch;
+
+          measure("render", params_size(size) +
+            ",\"mode\":" + json_str(mode_name) +
+            ",\"seconds\":" + (seconds ? "true" : "false") +
+            ",\"color\":" + json_str(color), [&]() {
+              grid.size(size.width, size.height);
+              grid.clear(clock.cfg.style.background.value());
+              clock.render(size.width, size.height, grid, time++);
+              grid.flush(buf);
+
+              auto const bytes = buf.size();
+              buf.clear();
+
+              return bytes;
+            });
+        }
+      }
+    }
+  }
+}
+
+void bench_rect()
+{
+  for (auto const& size : sizes)
+  {
+    for (std::string const color : colors)
+    {
+      OB::Rect rect;
+      rect.xy(0, 0);
+      rect.xy_max(size.width, size.height);
+      rect.wh(size.width, size.height);
+      rect.border(true, true, true, true);
+      rect.padding(1, 1, 1, 1);
+      rect.align(OB::Rect::Align::center, OB::Rect::Align::center);
+      rect.color_fg(OB::Color(color_key(color, "red"), OB::Color::Type::fg));
+      rect.color_bg(OB::Color("236", OB::Color::Type::bg));
+      rect.text(OB::String::repeat(size.height / 2, "peaclock 世界\n"));
+
+      OB::Grid grid;
+      OB::Buffer buf;
+
+      measure("rect_draw", params_size(size) +
+        ",\"color\":" + json_str(color), [&]() {
+          grid.size(size.width, size.height);
+          grid.clear(0);
+          rect.draw(grid);
+          grid.flush(buf);
+
+          auto const bytes = buf.size();
+          buf.clear();
+
+          return bytes;
+        });
+    }
+  }
+}
+
+void bench_color()
+{
+  for (std::string const color : colors)
+  {
+    OB::Color val {color_key(color, "#ff8000"), OB::Color::Type::fg};
+
+    measure("color_step", "\"color\":" + json_str(color), [&]() {
+      return val.step().value().size();
+    });
+  }
+}
+
+void bench_text()
+{
+  for (auto const& size : sizes)
+  {
+    // a line of mixed ascii and wide graphemes spanning the terminal width
+    std::string const line {OB::String::repeat(size.width / 4, "ab世")};
+    OB::Text::View view;
+
+    measure("text_view_str", params_size(size), [&]() {
+      view.str(line);
+
+      return std::size_t {0};
+    });
+  }
+}
+
+void bench_cursor()
+{
+  std::size_t constexpr moves {1'000'000};
+
+  // the stringstream builder cursor_set used before it appended in place
+  auto const cursor_set_sstream = [](std::size_t const x, std::size_t const y) {
+    std::stringstream ss;
+    ss << aec::esc << "[" << y << ";" << x << "H";
+
+    return ss.str();
+  };
+
+  // 1M moves across an 80x24 screen, output in 64 KiB writes
+  auto const run = [&](auto&& move) {
+    OB::Buffer buf;
+    std::size_t bytes {0};
+
+    for (std::size_t i = 0; i < moves; ++i)
+    {
+      move(buf, (i % 80) + 1, ((i / 80) % 24) + 1);
+
+      if (buf.size() >= 65536)
+      {
+        bytes += buf.size();
+        buf.clear();
+      }
+    }
+
+    return bytes + buf.size();
+  };
+
+  measure("cursor_move", "\"moves\":1000000,\"api\":\"stringstream\"", [&]() {
+    return run([&](OB::Buffer& buf, std::size_t const x, std::size_t const y) {
+      buf << cursor_set_sstream(x, y);
+    });
+  });
+
+  measure("cursor_move", "\"moves\":1000000,\"api\":\"string\"", [&]() {
+    return run([](OB::Buffer& buf, std::size_t const x, std::size_t const y) {
+      buf << aec::cursor_set(x, y);
+    });
+  });
+
+  measure("cursor_move", "\"moves\":1000000,\"api\":\"buffer\"", [&]() {
+    return run([](OB::Buffer& buf, std::size_t const x, std::size_t const y) {
+      aec::cursor_set(buf, x, y);
+    });
+  });
+}
+
+// the dispatch Tui::command used before its table, the branch for the first
+// word built its regex on every call, and set tried its regexes in turn
+std::optional<std::vector<std::string>> command_regex(std::string const& input)
+{
+  std::string const str_s {"(?:'[^'\\\\]*(?:\\\\.[^'\\\\]*)*')"};
+  std::string const str_d {"(?:\"[^\\\"\\\\]*(?:\\\\.[^\\\"\\\\]*)*\")"};
+  std::string const str {"(?:" + str_s + "|" + str_d + ")"};
+  std::string const toggle {"(true|false|t|f|1|0|on|off)"};
+
+  std::array<std::pair<char const*, std::string>, 32> const branches {{
+    {"rate-input", "^rate-input(?:\\s+([0-9]+))?$"},
+    {"rate-refresh", "^rate-refresh(?:\\s+([0-9]+))?$"},
+    {"rate-status", "^rate-status(?:\\s+([0-9]+))?$"},
+    {"rate-animation", "^rate-animation(?:\\s+([0-9]+))?$"},
+    {"colour-depth", "^colour-depth(?:\\s+(auto|24|8|4))?$"},
+    {"stats", "^stats(?:\\s+(on|off|overlay))?$"},
+    {"locale", "^locale(?:\\s+(?:(" + str + ")))?$"},
+    {"timezone", "^timezone(?:\\s+(?:(" + str + ")))?$"},
+    {"date", "^date(?:\\s+(?:(" + str + ")))?$"},
+    {"fill", "^fill(?:\\s+(?:(" + str + ")))?$"},
+    {"fill-active", "^fill-active(?:\\s+(?:(" + str + ")))?$"},
+    {"fill-inactive", "^fill-inactive(?:\\s+(?:(" + str + ")))?$"},
+    {"fill-colon", "^fill-colon(?:\\s+(?:(" + str + ")))?$"},
+    {"mode", "^mode(?:\\s+(date|digital|binary|icon))?$"},
+    {"toggle", "^toggle(?:\\s+(block|padding|margin|ratio|active-fg|inactive-fg|colon-fg|active-bg|inactive-bg|colon-bg|date|background))?$"},
+    {"block", "^block(?:\\s+([0-9]+)\\s+([0-9]+))?$"},
+    {"block-x", "^block-x(?:\\s+([0-9]+))?$"},
+    {"block-y", "^block-y(?:\\s+([0-9]+))?$"},
+    {"padding", "^padding(?:\\s+([0-9]+)\\s+([0-9]+))?$"},
+    {"padding-x", "^padding-x(?:\\s+([0-9]+))?$"},
+    {"padding-y", "^padding-y(?:\\s+([0-9]+))?$"},
+    {"margin", "^margin(?:\\s+([0-9]+)\\s+([0-9]+))?$"},
+    {"margin-x", "^margin-x(?:\\s+([0-9]+))?$"},
+    {"margin-y", "^margin-y(?:\\s+([0-9]+))?$"},
+    {"ratio", "^ratio(?:\\s+([0-9]+)\\s+([0-9]+))?$"},
+    {"ratio-x", "^ratio-x(?:\\s+([0-9]+))?$"},
+    {"ratio-y", "^ratio-y(?:\\s+([0-9]+))?$"},
+    {"set", "^set\\s+date(?:\\s+" + toggle + ")?$"},
+    {"set", "^set\\s+seconds(?:\\s+" + toggle + ")?$"},
+    {"set", "^set\\s+hour-24(?:\\s+" + toggle + ")?$"},
+    {"set", "^set\\s+auto-size(?:\\s+" + toggle + ")?$"},
+    {"set", "^set\\s+auto-ratio(?:\\s+" + toggle + ")?$"},
+  }};
+
+  auto const keys = OB::String::split(input, " ", 2);
+
+  if (keys.empty())
+  {
+    return {};
+  }
+
+  for (auto const& [key, rx] : branches)
+  {
+    if (keys.at(0) != key)
+    {
+      continue;
+    }
+
+    if (auto match = OB::String::match(input, std::regex(rx)))
+    {
+      return match;
+    }
+  }
+
+  return {};
+}
+
+void bench_command()
+{
+  std::array<char const*, 6> const commands {{
+    "mode digital",
+    "set seconds on",
+    "style active-bg #ff8000",
+    "fill 'ab'",
+    "block 2 1",
+    "date '%a %b %d'",
+  }};
+
+  Tui tui;
+
+  for (std::string const command : commands)
+  {
+    // the regex dispatch as a baseline, followed by the same handler
+    for (auto const regex : {true, false})
+    {
+      measure("tui_command", "\"command\":" + json_str(command) +
+        ",\"dispatch\":" + (regex ? "\"regex\"" : "\"table\""), [&]() {
+          if (regex)
+          {
+            command_regex(command);
+          }
+
+          if (auto const res = tui.command(command); res && ! res.value().first)
+          {
+            throw std::runtime_error("command failed '" + command + "'");
+          }
+
+          return std::size_t {0};
+        });
+    }
+  }
+}
+
+void bench_config()
+{
+  // the cache is written next to the config, so work on a copy
+  auto const dir = fs::temp_directory_path() / "peaclock_bench";
+  auto const path = dir / "config";
+  fs::create_directories(dir);
+  fs::copy_file(ctx.config, path, fs::copy_options::overwrite_existing);
+  fs::remove(path.string() + ".cache");
+
+  // the command lines of the config, for the regex dispatch baseline
+  std::vector<std::string> commands;
+  std::ifstream file {path};
+
+  for (std::string line; std::getline(file, line);)
+  {
+    if (! line.empty() && line.front() != '#')
+    {
+      commands.emplace_back(line);
+    }
+  }
+
+  // the regex dispatch baseline loads without the cache and adds the
+  // regex each command built before the table
+  for (auto const& [cache, dispatch] : {std::pair{false, "regex"},
+    std::pair{false, "table"}, std::pair{true, "table"}})
+  {
+    Tui tui;
+    tui.headless(true);
+    tui.config_cache(cache);
+
+    measure("config_load", "\"config\":" + json_str(ctx.config) +
+      ",\"cache\":" + (cache ? "true" : "false") +
+      ",\"dispatch\":" + json_str(dispatch), [&, regex = std::string(dispatch) == "regex"]() {
+        tui.load_config(path);
+
+        if (regex)
+        {
+          for (auto const& e : commands)
+          {
+            command_regex(e);
+          }
+        }
+
+        return std::size_t {0};
+      });
+  }
+
+  fs::remove_all(dir);
+}
+
+void bench_hist_search()
+{
+  std::array<char const*, 4> const verbs {{"style", "mode", "fill", "toggle"}};
+  std::array<char const*, 4> const nouns {{"active-fg", "inactive-bg", "colon-fg", "date"}};
+
+  for (std::size_t const entries : {100ul, 1000ul})
+  {
+    OB::Readline readline;
+
+    for (std::size_t i = 0; i < entries; ++i)
+    {
+      readline.hist_push(std::string(verbs.at(i % verbs.size())) + " " +
+        nouns.at((i / verbs.size()) % nouns.size()) + " " + std::to_string(i));
+    }
+
+    for (std::string const query : {"sty act", "mode", "tgl dt 9"})
+    {
+      measure("readline_hist_search", "\"entries\":" + std::to_string(entries) +
+        ",\"query\":" + json_str(query), [&]() {
+          readline.hist_search(query);
+
+          return std::size_t {0};
+        });
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  std::ios_base::sync_with_stdio(false);
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string const arg {argv[i]};
+
+      if (arg == "--time" && i + 1 < argc)
+      {
+        ctx.time = std::chrono::milliseconds(std::stoul(argv[++i]));
+      }
+      else if (arg == "--filter" && i + 1 < argc)
+      {
+        ctx.filter = argv[++i];
+      }
+      else if (arg == "--seed" && i + 1 < argc)
+      {
+        ctx.seed = std::stoull(argv[++i]);
+      }
+      else if (arg == "--config" && i + 1 < argc)
+      {
+        ctx.config = argv[++i];
+      }
+      else
+      {
+        std::cerr << "usage: " << argv[0] << " [--time <milliseconds>] [--filter <bench>] [--seed <num>] [--config <file>]\n";
+
+        return 1;
+      }
+    }
+
+    OB::Random::shared().seed(ctx.seed);
+
+    bench_render();
+    bench_rect();
+    bench_color();
+    bench_text();
+    bench_cursor();
+    bench_command();
+    bench_config();
+    bench_hist_search();
+
+    std::cerr << "\n";
+
+    std::cout
+    << "{\"time_ms\":" << ctx.time.count()
+    << ",\"seed\":" << ctx.seed
+    << ",\"results\":[\n";
+
+    for (std::size_t i = 0; i < ctx.results.size(); ++i)
+    {
+      std::cout
+      << "  " << ctx.results.at(i)
+      << (i + 1 < ctx.results.size() ? ",\n" : "\n");
+    }
+
+    std::cout
+    << "]}\n";
+  }
+  catch(std::exception const& e)
+  {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -18,7 +18,8 @@ inline void program_init(Parg& pg)
   pg.name("peaclock").version("0.3.0 (07.05.2019)");
   pg.description("A responsive and customizable clock for the terminal.");
 
-  pg.usage("[--config-dir <dir>] [--config|-u <file>] [<file>] [--colour <on|off|auto>]");
+  pg.usage("[--config-dir <dir>] [--config|-u <file>] [--config-cache] [<file>] [--colour <on|off|auto>]");
+  pg.usage("--render-once <WxH[@TIME]> [--seed <num>] [--config-dir <dir>] [--config|-u <file>] [--config-cache]");
   pg.usage("[--help|-h] [--colour <on|off|auto>]");
   pg.usage("[--version|-v] [--colour <on|off|auto>]");
   pg.usage("[--license] [--colour <on|off|auto>]");
@@ -88,14 +89,34 @@ inline void program_init(Parg& pg)
         "display the icon with the date"},
     }},
     {"rate-input <milliseconds>", {
-      {"", "set the duration in milliseconds between reading user input"},
+      {"", "no effect, keys are read as soon as they arrive, kept so older configs still load"},
     }},
     {"rate-refresh <milliseconds>", {
-      {"", "set the duration in milliseconds between redrawing the output"},
+      {"", "set the duration in milliseconds between redrawing animated colours, otherwise the output is redrawn when the time shown changes"},
+    }},
+    {"rate-output <bytes>", {
+      {"", "set the bytes per second the output may use, 0 for no limit, when the output needs more than this, or more than the terminal is measured to drain, colour animation is stopped, then the seconds are hidden, then fills are drawn with spaces"},
     }},
     {"rate-status <milliseconds>", {
       {"", "set the duration in milliseconds to display status messages"},
     }},
+    {"rate-animation <milliseconds>", {
+      {"", "set the duration in milliseconds for the rainbow and candy colour modes to cycle through every hue"},
+    }},
+    {"colour-depth <value>", {
+      {"auto", "detect the colour depth of the terminal from the COLORTERM and TERM environment variables"},
+      {"24", "output 24-bit colours"},
+      {"8", "map colours to the nearest of the 256 colour palette"},
+      {"4", "map colours to the nearest of the 16 colour palette"},
+    }},
+    {"stats", {
+      {"", "show the average per-frame timings, bytes written, syscalls, and wakeups of the recent frames"},
+    }},
+    {"stats <value>", {
+      {"on", "start collecting frame stats"},
+      {"off", "stop collecting frame stats"},
+      {"overlay", "start collecting frame stats and draw a summary in the top right corner"},
+    }},
     {"locale <str>", {
       {"", "set the locale, for example 'en_CA.utf8', an empty string clears the value"},
     }},
@@ -287,7 +308,10 @@ inline void program_init(Parg& pg)
 
   // options
   pg.set("config,u", "", "file", "Use the commands in the config file 'file' for initialization. All other initializations are skipped. To skip all initializations, use the special name 'NONE'.");
+  pg.set("config-cache", "Save the settings from the config file to 'file.cache' next to it, and load them from there without parsing while the config file is unchanged.");
   pg.set("config-dir", "", "dir", "use 'dir' as the config directory. To skip all initializations, use the special name 'NONE'.");
+  pg.set("render-once", "", "WxH[@TIME]", "Write a single frame of size 'W' columns by 'H' rows to stdout and exit, without requiring a tty. 'TIME' is a unix timestamp in seconds, defaulting to the current time. Animated colours take their phase from 'TIME'.");
+  pg.set("seed", "", "num", "Seed the random colours of the party, candy, and rainbow colour modes with 'num' to make the output reproducible.");
   pg.set("colour", "auto", "on|off|auto", "Print the program info output with colour either on, off, or auto based on if stdout is a tty.");
 
   pg.set_pos();
@@ -3,6 +3,8 @@
 #include "ob/parg.hh"
 using Parg = OB::Parg;
 
+#include "ob/random.hh"
+
 #include "ob/term.hh"
 namespace iom = OB::Term::iomanip;
 namespace aec = OB::Term::ANSI_Escape_Codes;
@@ -12,9 +14,12 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <ctime>
 #include <cstddef>
+#include <cstdint>
 
 #include <string>
+#include <regex>
 #include <iostream>
 
 #include <filesystem>
@@ -32,19 +37,45 @@ int main(int argc, char *argv[])
   try
   {
     // init
+    if (pg.find("seed"))
+    {
+      auto const val = pg.get<std::string>("seed");
+
+      if (! std::regex_match(val, std::regex("^[0-9]{1,19}$")))
+      {
+        throw std::runtime_error("invalid seed value '" + val + "'");
+      }
+
+      OB::Random::shared().seed(std::stoull(val));
+    }
+
     Tui tui;
 
-    if (! OB::Term::is_term(STDOUT_FILENO))
+    if (pg.find("config-cache"))
     {
-      throw std::runtime_error("stdout is not a tty");
+      tui.config_cache(true);
     }
 
-    if (! OB::Term::is_term(STDIN_FILENO))
+    bool const render_once {pg.find("render-once")};
+
+    if (render_once)
     {
-      // reset stdin
-      int tty = open("/dev/tty", O_RDONLY);
-      dup2(tty, STDIN_FILENO);
-      close(tty);
+      tui.headless(true);
+    }
+    else
+    {
+      if (! OB::Term::is_term(STDOUT_FILENO))
+      {
+        throw std::runtime_error("stdout is not a tty");
+      }
+
+      if (! OB::Term::is_term(STDIN_FILENO))
+      {
+        // reset stdin
+        int tty = open("/dev/tty", O_RDONLY);
+        dup2(tty, STDIN_FILENO);
+        close(tty);
+      }
     }
 
     // load files
@@ -78,6 +109,27 @@ int main(int argc, char *argv[])
       }
     }
 
+    if (render_once)
+    {
+      // parse 'WxH[@TIME]'
+      std::smatch match;
+      auto const val = pg.get<std::string>("render-once");
+
+      if (! std::regex_match(val, match, std::regex("^([0-9]{1,5})x([0-9]{1,5})(?:@([0-9]{1,18}))?$")))
+      {
+        throw std::runtime_error("invalid render-once value '" + val + "', expected 'WxH[@TIME]'");
+      }
+
+      std::time_t const time {match[3].matched ?
+        static_cast<std::time_t>(std::stoll(match[3].str())) : std::time(nullptr)};
+
+      std::cout
+      << tui.render_once(std::stoul(match[1].str()), std::stoul(match[2].str()), time)
+      << std::flush;
+
+      return 0;
+    }
+
     // start event loop
     tui.run();
   }
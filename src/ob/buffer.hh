@@ -0,0 +1,143 @@
+#ifndef OB_BUFFER_HH
+#define OB_BUFFER_HH
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include <charconv>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace OB
+{
+
+// contiguous output bytes that keep their capacity when cleared,
+// so once it has grown to the size of a frame, appending never allocates
+class Buffer
+{
+public:
+
+  Buffer() = default;
+
+  explicit Buffer(std::size_t const capacity)
+  {
+    _buf.reserve(capacity);
+  }
+
+  Buffer& append(std::string_view const str)
+  {
+    _buf.append(str);
+
+    return *this;
+  }
+
+  Buffer& append(char const ch)
+  {
+    _buf.push_back(ch);
+
+    return *this;
+  }
+
+  // decimal digits of an integer
+  template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+  Buffer& append(T const val)
+  {
+    char str[std::numeric_limits<T>::digits10 + 2];
+    auto const res = std::to_chars(str, str + sizeof(str), val);
+    _buf.append(str, static_cast<std::size_t>(res.ptr - str));
+
+    return *this;
+  }
+
+  template<typename T>
+  Buffer& operator<<(T const& val)
+  {
+    return append(val);
+  }
+
+  std::string_view view() const
+  {
+    return _buf;
+  }
+
+  char const* data() const
+  {
+    return _buf.data();
+  }
+
+  std::size_t size() const
+  {
+    return _buf.size();
+  }
+
+  bool empty() const
+  {
+    return _buf.empty();
+  }
+
+  void reserve(std::size_t const capacity)
+  {
+    _buf.reserve(capacity);
+  }
+
+  // remove the contents, keeping the capacity
+  void clear()
+  {
+    _buf.clear();
+  }
+
+  // write the contents to a file descriptor, retrying partial writes,
+  // and waiting for a non-blocking descriptor to drain when it is full,
+  // returns false on error
+  bool write(int const fd) const
+  {
+    std::size_t pos {0};
+
+    while (pos < _buf.size())
+    {
+      auto const size = ::write(fd, _buf.data() + pos, _buf.size() - pos);
+
+      if (size > 0)
+      {
+        pos += static_cast<std::size_t>(size);
+
+        continue;
+      }
+
+      if (size == -1 && errno == EINTR)
+      {
+        continue;
+      }
+
+      // EWOULDBLOCK is the same value as EAGAIN on linux
+      if (size == -1 && errno == EAGAIN)
+      {
+        pollfd pfd {fd, POLLOUT, 0};
+
+        if (poll(&pfd, 1, -1) == -1 && errno != EINTR)
+        {
+          return false;
+        }
+
+        continue;
+      }
+
+      return false;
+    }
+
+    return true;
+  }
+
+private:
+
+  std::string _buf;
+}; // class Buffer
+
+} // namespace OB
+
+#endif // OB_BUFFER_HH
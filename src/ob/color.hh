@@ -1,6 +1,7 @@
 #ifndef OB_COLOR_HH
 #define OB_COLOR_HH
 
+#include "ob/random.hh"
 #include "ob/string.hh"
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
@@ -8,11 +9,14 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <cmath>
 #include <cstdio>
 #include <cstddef>
+#include <cstdint>
 
-#include <regex>
+#include <array>
+#include <limits>
+#include <memory>
 #include <string>
-#include <random>
 #include <sstream>
+#include <string_view>
 #include <iostream>
 #include <algorithm>
 #include <unordered_map>
@@ -22,6 +26,38 @@ namespace OB
 
 class Color
 {
+public:
+
+  struct RGB
+  {
+    // range [0-255]
+    double r {0};
+    double g {0};
+    double b {0};
+  };
+
+private:
+
+  // xterm default values of the 16 colour palette
+  inline static const std::array<RGB, 16> palette_16 {{
+    {0, 0, 0},
+    {205, 0, 0},
+    {0, 205, 0},
+    {205, 205, 0},
+    {0, 0, 238},
+    {205, 0, 205},
+    {0, 205, 205},
+    {229, 229, 229},
+    {127, 127, 127},
+    {255, 0, 0},
+    {0, 255, 0},
+    {255, 255, 0},
+    {92, 92, 255},
+    {255, 0, 255},
+    {0, 255, 255},
+    {255, 255, 255},
+  }};
+
   inline static const std::unordered_map<std::string, std::string> color_fg {
     {"black", "\x1b[30m"},
     {"black bright", "\x1b[90m"},
@@ -73,14 +109,6 @@ public:
     };
   };
 
-  struct RGB
-  {
-    // range [0-255]
-    double r {0};
-    double g {0};
-    double b {0};
-  };
-
   struct HSL
   {
     // range [0-1]
@@ -207,8 +235,7 @@ public:
       case Mode::rainbow:
       {
         _hsl.h = _hsl.h < 100 ? _hsl.h + 0.2 : 0;
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _value = hue_value();
 
         break;
       }
@@ -216,8 +243,7 @@ public:
       case Mode::candy:
       {
         _hsl.h = _hsl.h < 100 ? _hsl.h + 0.4 : 0;
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _value = hue_value();
 
         break;
       }
@@ -225,8 +251,42 @@ public:
       case Mode::party:
       {
         _hsl.h = random(0, 100);
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _value = hue_value();
+
+        break;
+      }
+
+      case Mode::null:
+      default:
+      {
+        break;
+      }
+    }
+
+    return *this;
+  }
+
+  // set the hue of the animated modes from a position in their animation cycle,
+  // range [0-1), rainbow passes through every hue once per cycle and candy twice,
+  // party picks a new random hue, step() then moves along from there
+  Color& phase(double const val)
+  {
+    switch(_mode)
+    {
+      case Mode::rainbow:
+      case Mode::candy:
+      {
+        _hue_offset = std::fmod(val * (_mode == Mode::candy ? 200 : 100), 100);
+        _hsl.h = std::fmod(_hue_base + _hue_offset, 100);
+        _value = hue_value();
+
+        break;
+      }
+
+      case Mode::party:
+      {
+        _hsl.h = random(0, 100);
+        _value = hue_value();
 
         break;
       }
@@ -261,6 +321,9 @@ public:
       _hsl.h = val;
     }
 
+    // keep the animation cycle going from the new hue
+    _hue_base = std::fmod(_hsl.h - _hue_offset + 100, 100);
+
     _key = hsl_to_hex(_hsl);
     _value = _fg ? aec::fg_true(_key) : aec::bg_true(_key);
 
@@ -375,24 +438,30 @@ public:
 
         _key = k;
         _hsl.h = random(0, 100);
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _hue_base = _hsl.h;
+        _hue_offset = 0;
+        _value = hue_value();
         _valid = true;
       }
       else
       {
         // 21-bit color
-        if (k.at(0) == '#' && OB::String::assert_rx(k,
-          std::regex("^#[0-9a-fA-F]{3}(?:[0-9a-fA-F]{3})?$")))
+        if (std::string hex {k}; k.at(0) == '#' && valid_hstr(hex))
         {
+          auto const rgb = hex_to_rgb(hex);
+
           _key = k;
-          _value = _fg ? aec::fg_true(k) : aec::bg_true(k);
-          _hsl = hex_to_hsl(k);
+          _value = aec::esc + (_fg ? "[38;2;" : "[48;2;") +
+            std::to_string(static_cast<int>(rgb.r)) + ";" +
+            std::to_string(static_cast<int>(rgb.g)) + ";" +
+            std::to_string(static_cast<int>(rgb.b)) + "m";
+          _hsl = rgb_to_hsl(rgb);
           _valid = true;
         }
 
         // 8-bit color
-        else if (OB::String::assert_rx(k, std::regex("^[0-9]{1,3}$")) &&
+        else if (k.size() <= 3 && std::all_of(k.begin(), k.end(),
+          [](char const c) { return c >= '0' && c <= '9'; }) &&
           std::stoi(k) >= 0 && std::stoi(k) <= 255)
         {
           _key = k;
@@ -422,13 +491,190 @@ public:
     return _valid;
   }
 
-  std::string value() const
+  std::string const& value() const
   {
     return _value;
   }
 
+  // hue range [0-100] is quantized into this many steps of 0.2,
+  // the finest step used by the animated modes
+  static constexpr std::size_t hue_steps {500};
+
+  // escape sequences for every quantized hue at a single saturation and lightness
+  struct Hue_Table
+  {
+    std::array<std::string, hue_steps + 1> fg_true;
+    std::array<std::string, hue_steps + 1> bg_true;
+  };
+
+  // tables are built on first use for each saturation and lightness,
+  // and live until the program exits
+  Hue_Table const& hue_table(double const sat, double const lum) const
+  {
+    static std::unordered_map<long, Hue_Table> tables;
+
+    auto const [it, inserted] = tables.try_emplace(
+      std::lround(sat * 100) * 100000 + std::lround(lum * 100));
+    auto& table = it->second;
+
+    if (inserted)
+    {
+      for (std::size_t i = 0; i <= hue_steps; ++i)
+      {
+        auto const rgb = hsl_to_rgb(HSL {static_cast<double>(i) * 100 / hue_steps, sat, lum});
+        auto const val = std::to_string(static_cast<unsigned int>(rgb.r)) + ";" +
+          std::to_string(static_cast<unsigned int>(rgb.g)) + ";" +
+          std::to_string(static_cast<unsigned int>(rgb.b)) + "m";
+
+        table.fg_true[i] = aec::esc + "[38;2;" + val;
+        table.bg_true[i] = aec::esc + "[48;2;" + val;
+      }
+    }
+
+    return table;
+  }
+
+  // output colour depth in bits
+  struct Depth
+  {
+    enum Type
+    {
+      bit4 = 4,
+      bit8 = 8,
+      bit24 = 24,
+    };
+  };
+
+  // rgb of an index in the xterm 256 colour palette
+  static RGB rgb_256(std::size_t const idx)
+  {
+    if (idx < palette_16.size())
+    {
+      return palette_16.at(idx);
+    }
+
+    if (idx < 232)
+    {
+      auto const value = [](std::size_t const lvl) {
+        return lvl ? 55.0 + 40.0 * static_cast<double>(lvl) : 0.0;
+      };
+
+      return RGB {value((idx - 16) / 36), value(((idx - 16) / 6) % 6), value((idx - 16) % 6)};
+    }
+
+    auto const val = 8.0 + 10.0 * static_cast<double>(idx - 232);
+
+    return RGB {val, val, val};
+  }
+
+  // nearest colour in the 16 colour palette
+  static std::size_t rgb_to_16(RGB const& rgb)
+  {
+    std::size_t res {0};
+    double min {std::numeric_limits<double>::max()};
+
+    for (std::size_t i = 0; i < palette_16.size(); ++i)
+    {
+      auto const& e = palette_16.at(i);
+      auto const dist = (rgb.r - e.r) * (rgb.r - e.r) +
+        (rgb.g - e.g) * (rgb.g - e.g) + (rgb.b - e.b) * (rgb.b - e.b);
+
+      if (dist < min)
+      {
+        min = dist;
+        res = i;
+      }
+    }
+
+    return res;
+  }
+
+  // palette index of an rgb colour at a depth below 24 bits, from lookup tables
+  // with 32 levels per channel that are built on first use
+  static std::size_t palette(Depth::Type const depth,
+    std::uint8_t const r, std::uint8_t const g, std::uint8_t const b)
+  {
+    struct Lut
+    {
+      std::array<std::uint8_t, 32 * 32 * 32> bit8;
+      std::array<std::uint8_t, 32 * 32 * 32> bit4;
+    };
+
+    static auto const lut = []() {
+      auto res = std::make_unique<Lut>();
+
+      for (std::size_t i = 0; i < res->bit8.size(); ++i)
+      {
+        // the centre of the bin
+        RGB const rgb {
+          static_cast<double>(((i >> 10) << 3) + 4),
+          static_cast<double>((((i >> 5) & 31) << 3) + 4),
+          static_cast<double>(((i & 31) << 3) + 4)};
+
+        res->bit8[i] = static_cast<std::uint8_t>(rgb_to_256(rgb));
+        res->bit4[i] = static_cast<std::uint8_t>(rgb_to_16(rgb));
+      }
+
+      return res;
+    }();
+
+    std::size_t const idx {(static_cast<std::size_t>(r >> 3) << 10) |
+      (static_cast<std::size_t>(g >> 3) << 5) | static_cast<std::size_t>(b >> 3)};
+
+    return depth == Depth::bit8 ? lut->bit8[idx] : lut->bit4[idx];
+  }
+
+  // nearest colour in the xterm 256 colour palette,
+  // either from the 6x6x6 cube or the grayscale ramp
+  static std::size_t rgb_to_256(RGB const& rgb)
+  {
+    auto const level = [](double const val) {
+      return val < 48 ? 0 : val < 115 ? 1 : static_cast<std::size_t>((val - 35) / 40);
+    };
+
+    auto const value = [](std::size_t const lvl) {
+      return lvl ? 55.0 + 40.0 * static_cast<double>(lvl) : 0.0;
+    };
+
+    auto const dist = [&](double const r, double const g, double const b) {
+      return (rgb.r - r) * (rgb.r - r) + (rgb.g - g) * (rgb.g - g) + (rgb.b - b) * (rgb.b - b);
+    };
+
+    auto const r = level(rgb.r);
+    auto const g = level(rgb.g);
+    auto const b = level(rgb.b);
+    auto const cube = dist(value(r), value(g), value(b));
+
+    auto const avg = (rgb.r + rgb.g + rgb.b) / 3;
+    std::size_t const gray {avg > 238 ? 23 : avg < 8 ? 0 : static_cast<std::size_t>((avg - 3) / 10)};
+    auto const gray_val = 8.0 + 10.0 * static_cast<double>(gray);
+
+    if (dist(gray_val, gray_val, gray_val) < cube)
+    {
+      return 232 + gray;
+    }
+
+    return 16 + (36 * r) + (6 * g) + b;
+  }
+
 private:
 
+  // escape sequence of the current hsl from the hue lookup table
+  std::string const& hue_value()
+  {
+    if (! _hue_table || _hue_table_sat != _hsl.s || _hue_table_lum != _hsl.l)
+    {
+      _hue_table = &hue_table(_hsl.s, _hsl.l);
+      _hue_table_sat = _hsl.s;
+      _hue_table_lum = _hsl.l;
+    }
+
+    auto const idx = static_cast<std::size_t>(
+      std::lround(std::clamp(_hsl.h, 0.0, 100.0) * hue_steps / 100));
+
+    return _fg ? _hue_table->fg_true[idx] : _hue_table->bg_true[idx];
+  }
+
   HSL hex_to_hsl(std::string const& hex) const
   {
     return rgb_to_hsl(hex_to_rgb(hex));
@@ -459,38 +705,72 @@ private:
     return std::string(s);
   }
 
-  std::size_t hex_decode(std::string const& str_) const
+  static int hex_digit(char const c)
   {
-    std::stringstream ss;
-    ss << str_;
-    std::size_t val;
-    ss >> std::hex >> val;
+    if (c >= '0' && c <= '9')
+    {
+      return c - '0';
+    }
 
-    return val;
+    if (c >= 'a' && c <= 'f')
+    {
+      return c - 'a' + 10;
+    }
+
+    if (c >= 'A' && c <= 'F')
+    {
+      return c - 'A' + 10;
+    }
+
+    return -1;
   }
 
-  bool valid_hstr(std::string& str) const
+  std::size_t hex_decode(std::string const& str_) const
   {
-    std::smatch m;
-    std::regex rx {"^#?((?:[0-9a-fA-F]{3}){1,2})$"};
+    std::size_t val {0};
 
-    if (std::regex_match(str, m, rx, std::regex_constants::match_not_null))
+    for (auto const c : str_)
     {
-      std::string hstr {m[1]};
+      auto const n = hex_digit(c);
 
-      if (hstr.size() == 3)
+      if (n < 0)
       {
-        std::stringstream ss;
-        ss << hstr[0] << hstr[0] << hstr[1] << hstr[1] << hstr[2] << hstr[2];
-        hstr = ss.str();
+        break;
       }
 
-      str = hstr;
+      val = (val * 16) + static_cast<std::size_t>(n);
+    }
 
-      return true;
+    return val;
+  }
+
+  // accepts an optional '#' followed by 3 or 6 hex digits,
+  // normalizes str to the 6 digit form without the '#'
+  bool valid_hstr(std::string& str) const
+  {
+    std::string_view hstr {str};
+
+    if (! hstr.empty() && hstr.front() == '#')
+    {
+      hstr.remove_prefix(1);
+    }
+
+    if ((hstr.size() != 3 && hstr.size() != 6) || ! std::all_of(hstr.begin(), hstr.end(),
+      [](char const c) { return hex_digit(c) >= 0; }))
+    {
+      return false;
     }
 
-    return false;
+    if (hstr.size() == 3)
+    {
+      str = {hstr[0], hstr[0], hstr[1], hstr[1], hstr[2], hstr[2]};
+    }
+    else
+    {
+      str = std::string(hstr);
+    }
+
+    return true;
   }
 
   RGB hex_to_rgb(std::string str) const
@@ -626,11 +906,7 @@ private:
 
   std::size_t random(std::size_t min, std::size_t max) const
   {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distr(min, max);
-
-    return static_cast<std::size_t>(distr(gen));
+    return OB::Random::shared().range(min, max);
   }
 
   bool _valid {false};
@@ -641,6 +917,15 @@ private:
   bool _rainbow;
   Mode::Type _mode {Mode::null};
   HSL _hsl {50, 50, 50};
+
+  // starting hue of the animation cycle, and how far the cycle has moved it
+  double _hue_base {0};
+  double _hue_offset {0};
+
+  // cached hue table for the current saturation and lightness
+  Hue_Table const* _hue_table {nullptr};
+  double _hue_table_sat {0};
+  double _hue_table_lum {0};
 }; // Color
 
 } // namespace OB
@@ -0,0 +1,144 @@
+#ifndef OB_FILE_WATCH_HH
+#define OB_FILE_WATCH_HH
+
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include <string>
+#include <system_error>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace OB
+{
+
+// notices when a file is written or replaced, using inotify,
+// the parent directory is watched so that editors which save by renaming
+// a new file over the old one are noticed as well
+class File_Watch
+{
+public:
+
+  File_Watch() = default;
+
+  File_Watch(File_Watch const&) = delete;
+  File_Watch& operator=(File_Watch const&) = delete;
+
+  ~File_Watch()
+  {
+    close();
+  }
+
+  // start watching a file, returns false when inotify is unavailable
+  bool watch(fs::path const& path)
+  {
+    close();
+
+    // watch where a symlink points to, as that is the file being edited
+    std::error_code ec;
+    auto file = fs::canonical(path, ec);
+
+    if (ec)
+    {
+      file = fs::absolute(path, ec);
+
+      if (ec)
+      {
+        return false;
+      }
+    }
+
+    _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (_fd == -1)
+    {
+      return false;
+    }
+
+    // only events for a file that is complete, never one being written
+    _wd = inotify_add_watch(_fd, file.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    if (_wd == -1)
+    {
+      close();
+
+      return false;
+    }
+
+    _name = file.filename();
+
+    return true;
+  }
+
+  // drain the pending events, returns true if the file changed since the
+  // last call, never blocks
+  bool changed()
+  {
+    if (_fd == -1)
+    {
+      return false;
+    }
+
+    bool res {false};
+    alignas(inotify_event) char buf[4096];
+
+    while (true)
+    {
+      auto const size = read(_fd, buf, sizeof(buf));
+
+      if (size <= 0)
+      {
+        if (size == -1 && errno == EINTR)
+        {
+          continue;
+        }
+
+        break;
+      }
+
+      for (std::size_t i = 0; i < static_cast<std::size_t>(size);)
+      {
+        auto const* event = reinterpret_cast<inotify_event const*>(buf + i);
+
+        if (event->len && _name == event->name)
+        {
+          res = true;
+        }
+
+        i += sizeof(inotify_event) + event->len;
+      }
+    }
+
+    return res;
+  }
+
+  // file descriptor to wait on, -1 when not watching
+  int fd() const
+  {
+    return _fd;
+  }
+
+  void close()
+  {
+    if (_fd != -1)
+    {
+      ::close(_fd);
+      _fd = -1;
+      _wd = -1;
+    }
+  }
+
+private:
+
+  int _fd {-1};
+  int _wd {-1};
+  std::string _name;
+}; // class File_Watch
+
+} // namespace OB
+
+#endif // OB_FILE_WATCH_HH
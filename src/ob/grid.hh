@@ -0,0 +1,1021 @@
+#ifndef OB_GRID_HH
+#define OB_GRID_HH
+
+#include "ob/text.hh"
+#include "ob/term.hh"
+#include "ob/color.hh"
+#include "ob/buffer.hh"
+namespace aec = OB::Term::ANSI_Escape_Codes;
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace OB
+{
+
+class Grid
+{
+public:
+
+  using style_type = std::uint32_t;
+
+  static std::size_t constexpr npos {std::numeric_limits<std::size_t>::max()};
+
+  struct Cell
+  {
+    // utf-8 grapheme, empty when covered by the wide grapheme before it
+    std::string str {" "};
+
+    // interned sgr sequences
+    style_type fg {0};
+    style_type bg {0};
+
+    bool operator==(Cell const& rhs) const
+    {
+      return fg == rhs.fg && bg == rhs.bg && str == rhs.str;
+    }
+
+    bool operator!=(Cell const& rhs) const
+    {
+      return ! (*this == rhs);
+    }
+  };
+
+  // output statistics of the last flush
+  struct Stats
+  {
+    // cells written
+    std::size_t cells {0};
+
+    // bytes written
+    std::size_t bytes {0};
+
+    // bytes saved by only emitting the sgr attributes that changed,
+    // compared to resetting and setting every attribute on each style change
+    std::size_t sgr_saved {0};
+
+    // bytes saved by choosing the shortest cursor movement and erasing
+    // runs of blanks, compared to an absolute move and writing every blank
+    std::size_t move_saved {0};
+  };
+
+  Grid()
+  {
+    style_reset();
+  }
+
+  Grid(Grid&&) = default;
+  Grid(Grid const&) = default;
+  ~Grid() = default;
+
+  Grid& operator=(Grid&&) = default;
+  Grid& operator=(Grid const&) = default;
+
+  std::size_t width() const
+  {
+    return _width;
+  }
+
+  std::size_t height() const
+  {
+    return _height;
+  }
+
+  Grid& size(std::size_t const width, std::size_t const height)
+  {
+    if (width == _width && height == _height)
+    {
+      return *this;
+    }
+
+    _width = width;
+    _height = height;
+
+    _back.assign(_width * _height, Cell());
+    _front.assign(_width * _height, Cell());
+
+    return invalidate();
+  }
+
+  Color::Depth::Type depth() const
+  {
+    return _depth;
+  }
+
+  // colour depth of the output, colours above it are mapped to the nearest
+  // palette entry once when their style is interned
+  Grid& depth(Color::Depth::Type const val)
+  {
+    if (val == _depth)
+    {
+      return *this;
+    }
+
+    _depth = val;
+
+    // the interned styles were mapped for the old depth
+    style_reset();
+    _back.assign(_width * _height, Cell());
+
+    return invalidate();
+  }
+
+  // map an sgr sequence to a small id, the empty sequence is always 0
+  style_type style(std::string const& sgr)
+  {
+    if (auto const it = _style_map.find(sgr); it != _style_map.end())
+    {
+      return it->second;
+    }
+
+    auto const val = quantize(sgr);
+
+    // colours that map to the same palette entry share an id
+    if (val != sgr)
+    {
+      if (auto const it = _style_map.find(val); it != _style_map.end())
+      {
+        _style_map.emplace(sgr, it->second);
+
+        return it->second;
+      }
+
+      _style_map.emplace(sgr, static_cast<style_type>(_style.size()));
+    }
+
+    auto const id = static_cast<style_type>(_style.size());
+    _style.emplace_back(val);
+    _style_map.emplace(val, id);
+    _attr.emplace_back(attr(val));
+
+    return id;
+  }
+
+  std::string const& style(style_type const id) const
+  {
+    return _style.at(id);
+  }
+
+  // reset the back buffer to blank cells using the given background sgr,
+  // style ids interned before the call are no longer valid after it
+  Grid& clear(std::string const& sgr = {})
+  {
+    // animated colours keep adding styles, start over once the table
+    // grows too large and repaint everything with the new ids
+    if (_style.size() > style_max)
+    {
+      style_reset();
+      invalidate();
+    }
+
+    auto const bg = style(sgr);
+
+    for (auto& e : _back)
+    {
+      e.str = " ";
+      e.fg = 0;
+      e.bg = bg;
+    }
+
+    return *this;
+  }
+
+  // forget what is on the terminal, the next flush repaints every cell
+  Grid& invalidate()
+  {
+    _dirty = true;
+
+    return *this;
+  }
+
+  Cell& at(std::size_t const x, std::size_t const y)
+  {
+    return _back.at(x + (y * _width));
+  }
+
+  Grid& put(std::size_t const x, std::size_t const y, std::string_view const str,
+    std::size_t const cols, style_type const fg, style_type const bg)
+  {
+    if (x >= _width || y >= _height || (cols == 2 && x + 1 >= _width))
+    {
+      return *this;
+    }
+
+    auto const i = x + (y * _width);
+
+    // break up any wide grapheme being partially overwritten
+    if (_back[i].str.empty() && x > 0)
+    {
+      _back[i - 1].str = " ";
+    }
+
+    auto const end = i + cols;
+
+    if (end < _back.size() && (end % _width) != 0 && _back[end].str.empty())
+    {
+      _back[end].str = " ";
+    }
+
+    _back[i].str = str;
+    _back[i].fg = fg;
+    _back[i].bg = bg;
+
+    if (cols == 2)
+    {
+      _back[i + 1].str.clear();
+      _back[i + 1].fg = fg;
+      _back[i + 1].bg = bg;
+    }
+
+    return *this;
+  }
+
+  // copy a row of pre-rendered cells
+  Grid& put(std::size_t const x, std::size_t const y, std::vector<Cell> const& cells)
+  {
+    if (x >= _width || y >= _height || cells.empty())
+    {
+      return *this;
+    }
+
+    auto const size = std::min(cells.size(), _width - x);
+    auto const i = x + (y * _width);
+    auto const end = i + size;
+
+    // break up any wide grapheme being partially overwritten
+    if (_back[i].str.empty() && x > 0)
+    {
+      _back[i - 1].str = " ";
+    }
+
+    if (x + size < _width && _back[end].str.empty())
+    {
+      _back[end].str = " ";
+    }
+
+    std::copy(cells.begin(), cells.begin() + static_cast<long int>(size),
+      _back.begin() + static_cast<long int>(i));
+
+    // a wide grapheme cut off by the right edge
+    if (size < cells.size() && cells[size].str.empty())
+    {
+      _back[end - 1].str = " ";
+    }
+
+    return *this;
+  }
+
+  // fill a rectangle with a single column grapheme
+  Grid& fill(std::size_t const x, std::size_t const y, std::size_t const w,
+    std::size_t const h, std::string_view const str, style_type const fg,
+    style_type const bg)
+  {
+    for (std::size_t j = y; j < y + h && j < _height; ++j)
+    {
+      for (std::size_t i = x; i < x + w && i < _width; ++i)
+      {
+        put(i, j, str, 1, fg, bg);
+      }
+    }
+
+    return *this;
+  }
+
+  // write a line of text, returns the number of columns used
+  std::size_t text(std::size_t const x, std::size_t const y, std::string_view const str,
+    style_type const fg, style_type const bg)
+  {
+    std::size_t cols {0};
+
+    for (auto const& e : OB::Text::View(str))
+    {
+      put(x + cols, y, e.str, e.cols, fg, bg);
+      cols += e.cols;
+    }
+
+    return cols;
+  }
+
+  // write the cells that differ from what is on the terminal,
+  // returns the number of cells written
+  std::size_t flush(Buffer& buf)
+  {
+    _stats = Stats();
+    auto const begin = buf.size();
+
+    // unknown cursor position and sgr state
+    std::size_t x_cur {npos};
+    std::size_t y_cur {npos};
+    _pen = Pen();
+
+    for (std::size_t y = 0; y < _height; ++y)
+    {
+      for (std::size_t x = 0; x < _width; ++x)
+      {
+        auto const i = x + (y * _width);
+        auto const& back = _back[i];
+        auto& front = _front[i];
+
+        if (! _dirty && back == front)
+        {
+          continue;
+        }
+
+        front = back;
+
+        // covered by the wide grapheme to the left
+        if (back.str.empty())
+        {
+          continue;
+        }
+
+        if (x != x_cur || y != y_cur)
+        {
+          move(buf, x_cur, y_cur, x, y);
+        }
+
+        pen(buf, back.fg, back.bg);
+
+        // erase a run of blanks in the default background without moving,
+        // the cursor then moves past it only if there is more to write
+        if (auto const run = blanks(x, y); run)
+        {
+          for (std::size_t j = i; j < i + run; ++j)
+          {
+            _front[j] = _back[j];
+          }
+
+          buf << aec::esc << '[' << run << 'X';
+          _stats.cells += run;
+          _stats.move_saved += run - cost_erase(run);
+
+          x_cur = x;
+          y_cur = y;
+          x += run - 1;
+
+          continue;
+        }
+
+        buf << back.str;
+        ++_stats.cells;
+
+        std::size_t const cols {x + 1 < _width && _back[i + 1].str.empty() ? 2ul : 1ul};
+
+        // the cursor position is unreliable after writing the last column
+        x_cur = x + cols < _width ? x + cols : npos;
+        y_cur = x_cur == npos ? npos : y;
+      }
+    }
+
+    if (_stats.cells)
+    {
+      buf << aec::clear;
+    }
+
+    _stats.bytes = buf.size() - begin;
+    _dirty = false;
+
+    return _stats.cells;
+  }
+
+  Stats const& stats() const
+  {
+    return _stats;
+  }
+
+private:
+
+  // the terminal attribute an sgr sequence sets
+  struct Attr
+  {
+    enum Type
+    {
+      none = 0,
+      fg,
+      bg,
+      reverse,
+      other,
+    };
+  };
+
+  // sgr state of the terminal
+  struct Pen
+  {
+    // false when the state of the terminal is unknown
+    bool valid {false};
+
+    bool reverse {false};
+
+    // style ids of the current colours, 0 is the default colour
+    style_type fg {0};
+    style_type bg {0};
+
+    // style ids of the fg and bg sequences that can not be tracked
+    style_type other_fg {0};
+    style_type other_bg {0};
+
+    bool operator==(Pen const& rhs) const
+    {
+      return valid == rhs.valid && reverse == rhs.reverse &&
+        fg == rhs.fg && bg == rhs.bg &&
+        other_fg == rhs.other_fg && other_bg == rhs.other_bg;
+    }
+
+    bool other() const
+    {
+      return other_fg != 0 || other_bg != 0;
+    }
+  };
+
+  static Attr::Type attr(std::string const& sgr)
+  {
+    if (sgr.empty())
+    {
+      return Attr::none;
+    }
+
+    // a single sequence of the form 'ESC [ n ... m'
+    if (sgr.size() < 4 || sgr.compare(0, 2, "\x1b[") != 0 ||
+      sgr.back() != 'm' || sgr.find('\x1b', 1) != std::string::npos)
+    {
+      return Attr::other;
+    }
+
+    int n {0};
+
+    for (std::size_t i = 2; i < sgr.size() && sgr[i] >= '0' && sgr[i] <= '9'; ++i)
+    {
+      n = (n * 10) + (sgr[i] - '0');
+    }
+
+    if (n == 38 || (n >= 30 && n <= 37) || (n >= 90 && n <= 97))
+    {
+      return Attr::fg;
+    }
+
+    if (n == 48 || (n >= 40 && n <= 47) || (n >= 100 && n <= 107))
+    {
+      return Attr::bg;
+    }
+
+    if (n == 7 && sgr.size() == 4)
+    {
+      return Attr::reverse;
+    }
+
+    return Attr::other;
+  }
+
+  // decimal digits in a number
+  static std::size_t digits(std::size_t val)
+  {
+    std::size_t res {1};
+
+    while (val >= 10)
+    {
+      val /= 10;
+      ++res;
+    }
+
+    return res;
+  }
+
+  // bytes of an absolute move, the row and column are left out when they are 1
+  static std::size_t cost_cup(std::size_t const x, std::size_t const y)
+  {
+    return x == 0 ? (y == 0 ? 3 : 3 + digits(y + 1)) : 4 + digits(y + 1) + digits(x + 1);
+  }
+
+  // bytes of a relative move of n cells, the count is left out when it is 1
+  static std::size_t cost_rel(std::size_t const n)
+  {
+    return n == 1 ? 3 : 3 + digits(n);
+  }
+
+  // bytes of erasing n cells and then moving past them
+  static std::size_t cost_erase(std::size_t const n)
+  {
+    return 3 + digits(n) + cost_rel(n);
+  }
+
+  // bytes of rewriting the cells on the terminal from x0 up to x1 on row y,
+  // npos if they are not all single width cells in the current pen,
+  // or cost at least the limit
+  std::size_t cost_rewrite(std::size_t const y, std::size_t const x0,
+    std::size_t const x1, std::size_t const limit) const
+  {
+    if (! _pen.valid)
+    {
+      return npos;
+    }
+
+    std::size_t res {0};
+
+    for (std::size_t i = x0 + (y * _width), end = x1 + (y * _width); i < end; ++i)
+    {
+      auto const& cell = _front[i];
+
+      if (cell.str.empty() || _front[i + 1].str.empty() ||
+        cell.fg != _pen_fg || cell.bg != _pen_bg ||
+        (res += cell.str.size()) >= limit)
+      {
+        return npos;
+      }
+    }
+
+    return res;
+  }
+
+  // bytes to move along row y from column x0 to x1,
+  // rewrite is set when rewriting the cells in between is the shortest
+  std::size_t cost_row(std::size_t const y, std::size_t const x0,
+    std::size_t const x1, bool& rewrite) const
+  {
+    rewrite = false;
+
+    if (x0 == x1)
+    {
+      return 0;
+    }
+
+    // a backspace moves back a single cell
+    if (x1 < x0)
+    {
+      return x0 - x1 == 1 ? 1 : cost_rel(x0 - x1);
+    }
+
+    auto const rel = cost_rel(x1 - x0);
+    auto const res = cost_rewrite(y, x0, x1, rel);
+
+    if (res != npos)
+    {
+      rewrite = true;
+
+      return res;
+    }
+
+    return rel;
+  }
+
+  // emit the move along row y chosen by cost_row
+  void move_row(Buffer& buf, std::size_t const y, std::size_t const x0,
+    std::size_t const x1, bool const rewrite) const
+  {
+    if (x0 == x1)
+    {
+      return;
+    }
+
+    if (rewrite)
+    {
+      for (std::size_t i = x0 + (y * _width), end = x1 + (y * _width); i < end; ++i)
+      {
+        buf << _front[i].str;
+      }
+    }
+    else if (x1 < x0)
+    {
+      if (x0 - x1 == 1)
+      {
+        buf << '\b';
+      }
+      else
+      {
+        buf << aec::esc << '[' << x0 - x1 << 'D';
+      }
+    }
+    else
+    {
+      buf << aec::esc << '[';
+
+      if (x1 - x0 != 1)
+      {
+        buf << x1 - x0;
+      }
+
+      buf << 'C';
+    }
+  }
+
+  // move the cursor from x0 y0 to x1 y1 with the fewest bytes, choosing between
+  // an absolute move, relative moves, a carriage return and newline,
+  // and rewriting cells that are already on the terminal,
+  // npos for x0 or y0 is an unknown position
+  void move(Buffer& buf, std::size_t const x0, std::size_t const y0,
+    std::size_t const x1, std::size_t const y1)
+  {
+    auto const cup = cost_cup(x1, y1);
+
+    if (x0 == npos || y0 == npos)
+    {
+      move_cup(buf, x1, y1);
+
+      return;
+    }
+
+    enum {absolute, row, cr_row, crlf_row, vertical_row} how {absolute};
+    std::size_t best {cup};
+    bool rewrite {false};
+
+    auto const consider = [&](auto const type, std::size_t const extra,
+      std::size_t const x) {
+      bool val {false};
+
+      if (auto const cost = extra + cost_row(y1, x, x1, val); cost < best)
+      {
+        best = cost;
+        how = type;
+        rewrite = val;
+      }
+    };
+
+    if (y1 == y0)
+    {
+      consider(row, 0, x0);
+
+      if (x1 < x0)
+      {
+        consider(cr_row, 1, 0);
+      }
+    }
+    else
+    {
+      // a newline at the bottom row would scroll, which y1 rules out
+      if (y1 == y0 + 1)
+      {
+        consider(crlf_row, 2, 0);
+      }
+
+      consider(vertical_row, cost_rel(y1 > y0 ? y1 - y0 : y0 - y1), x0);
+    }
+
+    _stats.move_saved += cup - best;
+
+    switch (how)
+    {
+      case row:
+      {
+        move_row(buf, y1, x0, x1, rewrite);
+
+        break;
+      }
+
+      case cr_row:
+      {
+        buf << '\r';
+        move_row(buf, y1, 0, x1, rewrite);
+
+        break;
+      }
+
+      case crlf_row:
+      {
+        buf << "\r\n";
+        move_row(buf, y1, 0, x1, rewrite);
+
+        break;
+      }
+
+      case vertical_row:
+      {
+        auto const n = y1 > y0 ? y1 - y0 : y0 - y1;
+        buf << aec::esc << '[';
+
+        if (n != 1)
+        {
+          buf << n;
+        }
+
+        buf << (y1 > y0 ? 'B' : 'A');
+        move_row(buf, y1, x0, x1, rewrite);
+
+        break;
+      }
+
+      case absolute:
+      default:
+      {
+        move_cup(buf, x1, y1);
+
+        break;
+      }
+    }
+  }
+
+  static void move_cup(Buffer& buf, std::size_t const x, std::size_t const y)
+  {
+    if (x != 0)
+    {
+      aec::cursor_set(buf, x + 1, y + 1);
+    }
+    else if (y != 0)
+    {
+      buf << aec::esc << '[' << y + 1 << 'H';
+    }
+    else
+    {
+      buf << aec::esc << "[H";
+    }
+  }
+
+  // length of the run of blanks starting at x y that are still to be written,
+  // in the current pen with the default background, and shorter to erase,
+  // 0 otherwise
+  std::size_t blanks(std::size_t const x, std::size_t const y) const
+  {
+    // erasing fills with the background, without reverse or other attributes
+    if (! _pen.valid || _pen.bg != 0 || _pen.reverse || _pen.other())
+    {
+      return 0;
+    }
+
+    auto const begin = x + (y * _width);
+    auto const& cell = _back[begin];
+    std::size_t res {0};
+
+    for (auto i = begin, end = (y + 1) * _width; i < end; ++i, ++res)
+    {
+      auto const& e = _back[i];
+
+      if (e.str != " " || e.fg != cell.fg || e.bg != cell.bg || (! _dirty && e == _front[i]))
+      {
+        break;
+      }
+    }
+
+    return cost_erase(res) < res ? res : 0;
+  }
+
+  // map a 24-bit or 8-bit colour sequence down to the output colour depth
+  std::string quantize(std::string const& sgr) const
+  {
+    if (_depth == Color::Depth::bit24 || sgr.size() < 8 ||
+      sgr.compare(0, 2, "\x1b[") != 0 || sgr.back() != 'm' ||
+      sgr.find('\x1b', 1) != std::string::npos)
+    {
+      return sgr;
+    }
+
+    // parameters of the form 'n;n;n;n;n'
+    std::array<int, 5> param {};
+    std::size_t size {0};
+
+    for (std::size_t i = 2; i + 1 < sgr.size(); ++i)
+    {
+      if (sgr[i] == ';')
+      {
+        if (++size == param.size())
+        {
+          return sgr;
+        }
+      }
+      else if (sgr[i] >= '0' && sgr[i] <= '9')
+      {
+        param[size] = (param[size] * 10) + (sgr[i] - '0');
+      }
+      else
+      {
+        return sgr;
+      }
+    }
+
+    ++size;
+
+    bool const fg {param[0] == 38};
+
+    if (! fg && param[0] != 48)
+    {
+      return sgr;
+    }
+
+    std::size_t idx {0};
+
+    if (param[1] == 2 && size == 5)
+    {
+      auto const channel = [](int const val) {
+        return static_cast<std::uint8_t>(std::clamp(val, 0, 255));
+      };
+
+      idx = Color::palette(_depth, channel(param[2]), channel(param[3]), channel(param[4]));
+    }
+    else if (param[1] == 5 && size == 3 && _depth == Color::Depth::bit4)
+    {
+      idx = static_cast<std::size_t>(std::clamp(param[2], 0, 255));
+
+      if (idx >= 16)
+      {
+        idx = Color::rgb_to_16(Color::rgb_256(idx));
+      }
+    }
+    else
+    {
+      return sgr;
+    }
+
+    aec::Seq seq;
+
+    if (_depth == Color::Depth::bit8)
+    {
+      auto const val = static_cast<unsigned int>(idx);
+
+      return (fg ? aec::fg_256(seq, val) : aec::bg_256(seq, val)).str();
+    }
+
+    // 30-37 and 90-97 for fg, 40-47 and 100-107 for bg
+    seq << aec::esc << '[' << (fg ? 30 : 40) + (idx < 8 ? idx : idx + 52) << 'm';
+
+    return seq.str();
+  }
+
+  // bring the terminal sgr state to the given fg and bg styles,
+  // emitting only the attributes that change
+  void pen(Buffer& buf, style_type const fg, style_type const bg)
+  {
+    // what resetting and setting both styles would cost
+    std::size_t const naive {aec::clear.size() + _style[fg].size() + _style[bg].size()};
+
+    if (_pen.valid && _pen_fg == fg && _pen_bg == bg)
+    {
+      return;
+    }
+
+    _pen_fg = fg;
+    _pen_bg = bg;
+
+    Pen want;
+    want.valid = true;
+
+    for (auto const id : {fg, bg})
+    {
+      switch (_attr[id])
+      {
+        case Attr::fg:
+        {
+          want.fg = id;
+
+          break;
+        }
+
+        case Attr::bg:
+        {
+          want.bg = id;
+
+          break;
+        }
+
+        case Attr::reverse:
+        {
+          want.reverse = true;
+
+          break;
+        }
+
+        case Attr::other:
+        {
+          if (id == fg)
+          {
+            want.other_fg = id;
+          }
+          else
+          {
+            want.other_bg = id;
+          }
+
+          break;
+        }
+
+        case Attr::none:
+        default:
+        {
+          break;
+        }
+      }
+    }
+
+    if (_pen == want)
+    {
+      _stats.sgr_saved += naive;
+
+      return;
+    }
+
+    // a sequence that can not be tracked may change any attribute,
+    // so both styles are set after a reset in their own order
+    if (want.other())
+    {
+      buf
+      << aec::clear
+      << _style[fg]
+      << _style[bg];
+
+      _pen = want;
+
+      return;
+    }
+
+    // cost of setting everything after a reset
+    std::size_t const full {aec::clear.size() +
+      (want.reverse ? aec::reverse.size() : 0) +
+      _style[want.fg].size() + _style[want.bg].size()};
+
+    // cost of changing only the attributes that differ
+    std::size_t delta {npos};
+
+    if (_pen.valid && ! _pen.other())
+    {
+      delta =
+        (_pen.reverse != want.reverse ? (want.reverse ? aec::reverse : sgr_reverse_off).size() : 0) +
+        (_pen.fg != want.fg ? (want.fg ? _style[want.fg] : sgr_fg_default).size() : 0) +
+        (_pen.bg != want.bg ? (want.bg ? _style[want.bg] : sgr_bg_default).size() : 0);
+    }
+
+    if (delta < full)
+    {
+      if (_pen.reverse != want.reverse)
+      {
+        buf << (want.reverse ? aec::reverse : sgr_reverse_off);
+      }
+
+      if (_pen.fg != want.fg)
+      {
+        buf << (want.fg ? _style[want.fg] : sgr_fg_default);
+      }
+
+      if (_pen.bg != want.bg)
+      {
+        buf << (want.bg ? _style[want.bg] : sgr_bg_default);
+      }
+
+      _stats.sgr_saved += naive > delta ? naive - delta : 0;
+    }
+    else
+    {
+      buf << aec::clear;
+
+      if (want.reverse)
+      {
+        buf << aec::reverse;
+      }
+
+      buf
+      << _style[want.fg]
+      << _style[want.bg];
+
+      _stats.sgr_saved += naive > full ? naive - full : 0;
+    }
+
+    _pen = want;
+  }
+
+  void style_reset()
+  {
+    _style.clear();
+    _style_map.clear();
+    _attr.clear();
+    style("");
+  }
+
+  inline static std::string const sgr_reverse_off {"\x1b[27m"};
+  inline static std::string const sgr_fg_default {"\x1b[39m"};
+  inline static std::string const sgr_bg_default {"\x1b[49m"};
+
+  static std::size_t constexpr style_max {4096};
+
+  std::size_t _width {0};
+  std::size_t _height {0};
+
+  // repaint every cell on the next flush
+  bool _dirty {true};
+
+  Color::Depth::Type _depth {Color::Depth::bit24};
+
+  // cells being drawn
+  std::vector<Cell> _back;
+
+  // cells currently on the terminal
+  std::vector<Cell> _front;
+
+  // interned sgr sequences and the attribute each one sets
+  std::vector<std::string> _style;
+  std::vector<Attr::Type> _attr;
+  std::unordered_map<std::string, style_type> _style_map;
+
+  // sgr state of the terminal during a flush
+  Pen _pen;
+  style_type _pen_fg {0};
+  style_type _pen_bg {0};
+
+  Stats _stats;
+}; // class Grid
+
+} // namespace OB
+
+#endif // OB_GRID_HH
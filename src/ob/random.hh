@@ -0,0 +1,105 @@
+#ifndef OB_RANDOM_HH
+#define OB_RANDOM_HH
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <limits>
+#include <random>
+
+namespace OB
+{
+
+// small state pseudo random number generator, xoshiro256**
+// satisfies UniformRandomBitGenerator
+class Random
+{
+public:
+
+  using result_type = std::uint64_t;
+
+  // seed from the system entropy source
+  Random()
+  {
+    std::random_device rd;
+    seed((static_cast<std::uint64_t>(rd()) << 32) | rd());
+  }
+
+  explicit Random(std::uint64_t const val) noexcept
+  {
+    seed(val);
+  }
+
+  Random(Random const&) = default;
+  Random(Random&&) = default;
+
+  Random& operator=(Random const&) = default;
+  Random& operator=(Random&&) = default;
+
+  // the generator shared by the process, seeded on first use
+  static Random& shared()
+  {
+    static Random rng;
+
+    return rng;
+  }
+
+  // expand the seed into the full state with splitmix64
+  void seed(std::uint64_t val) noexcept
+  {
+    for (auto& e : _state)
+    {
+      val += 0x9e3779b97f4a7c15;
+
+      auto z = val;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      e = z ^ (z >> 31);
+    }
+  }
+
+  result_type operator()() noexcept
+  {
+    auto const res = rotl(_state[1] * 5, 7) * 9;
+    auto const t = _state[1] << 17;
+
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotl(_state[3], 45);
+
+    return res;
+  }
+
+  // integer in the closed range [min, max]
+  std::size_t range(std::size_t const min, std::size_t const max) noexcept
+  {
+    return min + static_cast<std::size_t>((*this)() % (max - min + 1));
+  }
+
+  static constexpr result_type min() noexcept
+  {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  static constexpr result_type max() noexcept
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+private:
+
+  static constexpr std::uint64_t rotl(std::uint64_t const val, int const n) noexcept
+  {
+    return (val << n) | (val >> (64 - n));
+  }
+
+  std::array<std::uint64_t, 4> _state {};
+}; // class Random
+
+} // namespace OB
+
+#endif // OB_RANDOM_HH
@@ -29,6 +29,7 @@ public:
 
   void hist_push(std::string const& str);
   void hist_load(fs::path const& path);
+  void hist_search(std::string const& str);
 
 private:
 
@@ -47,7 +48,6 @@ private:
   void hist_prev();
   void hist_next();
   void hist_reset();
-  void hist_search(std::string const& str);
   void hist_open(fs::path const& path);
   void hist_save(std::string const& str);
 
@@ -2,6 +2,8 @@
 #define OB_RECT_HH
 
 #include "ob/color.hh"
+#include "ob/grid.hh"
+#include "ob/string.hh"
 #include "ob/text.hh"
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
@@ -10,6 +12,7 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 
 #include <string>
 #include <iostream>
+#include <algorithm>
 
 namespace OB
 {
@@ -44,6 +47,11 @@ public:
 
   Rect& draw(std::ostream& os)
   {
+    if (solid())
+    {
+      return draw_solid(os);
+    }
+
     bool _border {false};
 
     if (_border_top || _border_bottom || _border_left || _border_right)
@@ -134,8 +142,7 @@ public:
 
     for (std::size_t y = 0; y < _h && y + _y <= _y_max; ++y)
     {
-      os
-      << aec::cursor_set(_x, y + _y);
+      aec::cursor_set(os, _x, y + _y);
 
       std::size_t cursor_right {0};
 
@@ -155,8 +162,7 @@ public:
                 style_main = ! style_main;
               }
 
-              os
-              << aec::cursor_right(cursor_right)
+              aec::cursor_right(os, cursor_right)
               << _corner_top_left;
 
               cursor_right = 0;
@@ -173,8 +179,7 @@ public:
                 style_main = ! style_main;
               }
 
-              os
-              << aec::cursor_right(cursor_right)
+              aec::cursor_right(os, cursor_right)
               << _corner_top_right;
 
               cursor_right = 0;
@@ -191,8 +196,7 @@ public:
                 style_main = ! style_main;
               }
 
-              os
-              << aec::cursor_right(cursor_right)
+              aec::cursor_right(os, cursor_right)
               << _corner_bottom_left;
 
               cursor_right = 0;
@@ -209,8 +213,7 @@ public:
                 style_main = ! style_main;
               }
 
-              os
-              << aec::cursor_right(cursor_right)
+              aec::cursor_right(os, cursor_right)
               << _line_top;
 
               cursor_right = 0;
@@ -227,8 +230,7 @@ public:
                 style_main = ! style_main;
               }
 
-              os
-              << aec::cursor_right(cursor_right)
+              aec::cursor_right(os, cursor_right)
               << _line_left;
 
               cursor_right = 0;
@@ -246,8 +248,7 @@ public:
               style_main = ! style_main;
             }
 
-            os
-            << aec::cursor_right(cursor_right)
+            aec::cursor_right(os, cursor_right)
             << _corner_bottom_right;
 
             cursor_right = 0;
@@ -264,8 +265,7 @@ public:
               style_main = ! style_main;
             }
 
-            os
-            << aec::cursor_right(cursor_right)
+            aec::cursor_right(os, cursor_right)
             << _line_bottom;
 
             cursor_right = 0;
@@ -282,8 +282,7 @@ public:
               style_main = ! style_main;
             }
 
-            os
-            << aec::cursor_right(cursor_right)
+            aec::cursor_right(os, cursor_right)
             << _line_right;
 
             cursor_right = 0;
@@ -380,7 +379,7 @@ public:
             ++cols;
           }
 
-          os << aec::cursor_right(cursor_right);
+          aec::cursor_right(os, cursor_right);
 
           cursor_right = 0;
 
@@ -423,8 +422,7 @@ public:
               ++cols;
             }
 
-            os
-            << aec::cursor_right(cursor_right)
+            aec::cursor_right(os, cursor_right)
             << ">";
 
             cursor_right = 0;
@@ -443,8 +441,7 @@ public:
           }
           else
           {
-            os
-            << aec::cursor_right(cursor_right)
+            aec::cursor_right(os, cursor_right)
             << _color_fg.step()
             << _fill;
 
@@ -457,6 +454,267 @@ public:
     return *this;
   }
 
+  Rect& draw(OB::Grid& grid)
+  {
+    if (solid())
+    {
+      return draw_solid(grid);
+    }
+
+    bool _border {false};
+
+    if (_border_top || _border_bottom || _border_left || _border_right)
+    {
+      _border = true;
+    }
+
+    bool _padding {false};
+
+    if (_padding_top || _padding_bottom || _padding_left || _padding_right)
+    {
+      _padding = true;
+    }
+
+    auto padding_top = _padding_top;
+    auto padding_bottom = _padding_bottom;
+    auto padding_left = _padding_left;
+    auto padding_right = _padding_right;
+
+    if (_border && _padding)
+    {
+      if (_border_top)
+      {
+        ++padding_top;
+      }
+
+      if (_border_bottom)
+      {
+        ++padding_bottom;
+      }
+
+      if (_border_left)
+      {
+        ++padding_left;
+      }
+
+      if (_border_right)
+      {
+        ++padding_right;
+      }
+    }
+
+    std::size_t text_width {_w - _border_left - _border_right - _padding_left - _padding_right};
+    std::size_t text_height {_h - _border_top - _border_bottom - _padding_top - _padding_bottom};
+
+    std::size_t row {0};
+    auto const ln = OB::String::split(_text, "\n");
+    OB::Text::View lnv;
+
+    auto fg = grid.style(_color_fg.value());
+    auto const bg = grid.style(_color_bg.value());
+    auto const border_fg = grid.style(_border_fg.value());
+    auto const border_bg = grid.style(_border_bg.value());
+
+    bool const animate {_color_fg.mode() != OB::Color::Mode::null};
+    bool const transparent {_fill == " " && _color_bg.key() == "clear"};
+
+    std::size_t y_begin {0};
+
+    // determine y axis alignment
+    switch (_y_align)
+    {
+      case Align::center:
+      {
+        if (text_height / 2 >= ln.size() / 2)
+        {
+          y_begin = text_height / 2 - ln.size() / 2;
+        }
+
+        break;
+      }
+
+      case Align::bottom:
+      {
+        if (text_height >= ln.size())
+        {
+          y_begin = text_height - ln.size();
+        }
+
+        break;
+      }
+
+      case Align::top:
+      default:
+      {
+        break;
+      }
+    }
+
+    for (std::size_t y = 0; y < _h && y + _y <= _y_max; ++y)
+    {
+      // grid coordinates are zero based
+      std::size_t const gy {y + _y - 1};
+
+      for (std::size_t x = 0; x < _w && x + _x <= _x_max; ++x)
+      {
+        std::size_t const gx {x + _x - 1};
+
+        if (_border)
+        {
+          std::string const* line {nullptr};
+
+          if (y == 0 || x == 0)
+          {
+            if (y == 0 && x == 0 && (_border_top || _border_left))
+            {
+              line = &_corner_top_left;
+            }
+            else if (y == 0 && x + 1 == _w && (_border_top || _border_right))
+            {
+              line = &_corner_top_right;
+            }
+            else if (y + 1 == _h && x == 0 && (_border_bottom || _border_left))
+            {
+              line = &_corner_bottom_left;
+            }
+            else if (y == 0 && _border_top)
+            {
+              line = &_line_top;
+            }
+            else if (x == 0 && _border_left)
+            {
+              line = &_line_left;
+            }
+          }
+          else if (y + 1 == _h && x + 1 == _w && (_border_bottom || _border_right))
+          {
+            line = &_corner_bottom_right;
+          }
+          else if (y + 1 == _h && _border_bottom)
+          {
+            line = &_line_bottom;
+          }
+          else if (x + 1 == _w && _border_right)
+          {
+            line = &_line_right;
+          }
+
+          if (line)
+          {
+            grid.put(gx, gy, *line, 1, border_fg, border_bg);
+
+            continue;
+          }
+        }
+
+        if (_padding)
+        {
+          if (y < padding_top || y + padding_bottom >= _h ||
+            x < padding_left || x + padding_right >= _w)
+          {
+            continue;
+          }
+        }
+
+        if (! _text.empty() && y >= y_begin && row < ln.size())
+        {
+          // set the view to the current line
+          lnv.str(ln.at(row++));
+
+          // total columns in the current line
+          auto tcols = lnv.cols();
+
+          // total columns used so far
+          std::size_t cols {0};
+
+          // determine x axis alignment
+          switch (_x_align)
+          {
+            case Align::center:
+            {
+              if (text_width / 2 >= tcols / 2)
+              {
+                cols = text_width / 2 - tcols / 2;
+              }
+
+              break;
+            }
+
+            case Align::right:
+            {
+              if (text_width >= tcols)
+              {
+                cols = text_width - tcols;
+              }
+
+              break;
+            }
+
+            case Align::left:
+            default:
+            {
+              break;
+            }
+          }
+
+          if (tcols <= text_width)
+          {
+            lnv.str(lnv.colstr(0, text_width));
+
+            for (auto const& e : lnv)
+            {
+              grid.put(gx + cols, gy, e.str, e.cols, fg, bg);
+              cols += e.cols;
+
+              if (_color_fg.mode() == OB::Color::Mode::party)
+              {
+                fg = grid.style(_color_fg.step().value());
+              }
+            }
+
+            if (cols < text_width)
+            {
+              cols = text_width;
+            }
+          }
+          else
+          {
+            lnv.str(lnv.colstr(0, text_width - 1));
+
+            for (auto const& e : lnv)
+            {
+              grid.put(gx + cols, gy, e.str, e.cols, fg, bg);
+              cols += e.cols;
+            }
+
+            if (cols + 1 < text_width)
+            {
+              cols = text_width - 1;
+            }
+
+            grid.put(gx + cols, gy, ">", 1, fg, bg);
+
+            ++cols;
+          }
+
+          // subtract 1 to counter the for loops ++x condition
+          x += cols - 1;
+        }
+        else if (! transparent)
+        {
+          if (animate)
+          {
+            fg = grid.style(_color_fg.step().value());
+          }
+
+          grid.put(gx, gy, _fill, 1, fg, bg);
+        }
+      }
+    }
+
+    return *this;
+  }
+
   Rect& align(Align x, Align y)
   {
     _x_align = x;
@@ -553,6 +811,67 @@ public:
 
 private:
 
+  // a plain coloured fill without text, border, or padding
+  bool solid() const
+  {
+    return _text.empty() && _color_fg.mode() == OB::Color::Mode::null &&
+      ! (_border_top || _border_bottom || _border_left || _border_right) &&
+      ! (_padding_top || _padding_bottom || _padding_left || _padding_right);
+  }
+
+  bool transparent() const
+  {
+    return _fill == " " && _color_bg.key() == "clear";
+  }
+
+  // columns and rows left after clipping to the max bounds
+  std::size_t cols() const
+  {
+    return _x_max >= _x ? std::min(_w, _x_max - _x + 1) : 0;
+  }
+
+  std::size_t rows() const
+  {
+    return _y_max >= _y ? std::min(_h, _y_max - _y + 1) : 0;
+  }
+
+  // one cursor move and one run of the fill string per row
+  Rect& draw_solid(std::ostream& os)
+  {
+    if (transparent())
+    {
+      return *this;
+    }
+
+    std::string const line {OB::String::repeat(cols(), _fill)};
+
+    os
+    << aec::clear
+    << _color_fg
+    << _color_bg;
+
+    for (std::size_t y = 0, h = rows(); y < h; ++y)
+    {
+      aec::cursor_set(os, _x, y + _y)
+      << line;
+    }
+
+    return *this;
+  }
+
+  Rect& draw_solid(OB::Grid& grid)
+  {
+    if (transparent() || ! _x || ! _y)
+    {
+      return *this;
+    }
+
+    grid.fill(_x - 1, _y - 1, cols(), rows(), _fill,
+      grid.style(_color_fg.value()), grid.style(_color_bg.value()));
+
+    return *this;
+  }
+
   std::size_t _x {0};
   std::size_t _y {0};
 
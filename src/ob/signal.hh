@@ -0,0 +1,108 @@
+#ifndef OB_SIGNAL_HH
+#define OB_SIGNAL_HH
+
+#include <unistd.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+
+#include <cerrno>
+
+#include <initializer_list>
+
+namespace OB
+{
+
+// receives signals as reads from a file descriptor, using signalfd,
+// the signals are blocked while open so they are never delivered
+// to a handler, and unblocked again on close
+class Signal
+{
+public:
+
+  Signal() = default;
+
+  Signal(Signal const&) = delete;
+  Signal& operator=(Signal const&) = delete;
+
+  ~Signal()
+  {
+    close();
+  }
+
+  // returns false when signalfd is unavailable, the signals are then unchanged
+  bool open(std::initializer_list<int> const signals)
+  {
+    close();
+
+    sigset_t set;
+    sigemptyset(&set);
+
+    for (auto const e : signals)
+    {
+      sigaddset(&set, e);
+    }
+
+    if (sigprocmask(SIG_BLOCK, &set, &_prev) == -1)
+    {
+      return false;
+    }
+
+    _fd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    if (_fd == -1)
+    {
+      sigprocmask(SIG_SETMASK, &_prev, nullptr);
+
+      return false;
+    }
+
+    return true;
+  }
+
+  // the next pending signal, 0 when there are none, never blocks
+  int next()
+  {
+    signalfd_siginfo info;
+
+    while (true)
+    {
+      if (read(_fd, &info, sizeof(info)) == sizeof(info))
+      {
+        return static_cast<int>(info.ssi_signo);
+      }
+
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return 0;
+    }
+  }
+
+  // file descriptor to wait on, -1 when closed
+  int fd() const
+  {
+    return _fd;
+  }
+
+  void close()
+  {
+    if (_fd != -1)
+    {
+      ::close(_fd);
+      _fd = -1;
+
+      sigprocmask(SIG_SETMASK, &_prev, nullptr);
+    }
+  }
+
+private:
+
+  int _fd {-1};
+  sigset_t _prev {};
+}; // class Signal
+
+} // namespace OB
+
+#endif // OB_SIGNAL_HH
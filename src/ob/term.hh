@@ -1,16 +1,20 @@
 #ifndef OB_TERM_HH
 #define OB_TERM_HH
 
+#include <poll.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
 
+#include <cerrno>
 #include <cstdio>
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 
+#include <array>
+#include <charconv>
 #include <iomanip>
 #include <streambuf>
 #include <iostream>
@@ -18,13 +22,14 @@
 #include <string>
 #include <string_view>
 #include <vector>
-#include <regex>
 #include <chrono>
 #include <thread>
 #include <utility>
 #include <limits>
 #include <algorithm>
 #include <stdexcept>
+#include <system_error>
+#include <type_traits>
 
 namespace OB::Term
 {
@@ -736,6 +741,118 @@ inline int size(std::size_t& width_, std::size_t& height_, std::size_t fd_ = STD
   return 0;
 }
 
+// ask the terminal for the state of a private mode with DECRQM, followed by
+// a device attributes request that every terminal answers, so a terminal
+// that doesn't know DECRQM is found out without waiting for the timeout,
+// returns the reported state, 0 not recognized, 1 set, 2 reset,
+// 3 permanently set, 4 permanently reset, or -1 when there was no reply
+inline int mode_report(int const mode, std::chrono::milliseconds const timeout)
+{
+  // NOTE term mode should be in raw state before call to this func
+
+  std::string req {"\x1b[?"};
+  req += std::to_string(mode);
+  req += "$p\x1b[c";
+
+  for (std::size_t pos {0}; pos < req.size();)
+  {
+    auto const size = write(STDOUT_FILENO, req.data() + pos, req.size() - pos);
+
+    if (size == -1 && errno != EINTR)
+    {
+      return -1;
+    }
+
+    if (size > 0)
+    {
+      pos += static_cast<std::size_t>(size);
+    }
+  }
+
+  auto const prefix = "\x1b[?" + std::to_string(mode) + ";";
+  auto const end = std::chrono::steady_clock::now() + timeout;
+  std::string res;
+  int state {-1};
+
+  while (true)
+  {
+    // the reply to the mode request, CSI ? mode ; state $ y
+    if (auto const i = res.find(prefix); state == -1 && i != std::string::npos)
+    {
+      auto const val = i + prefix.size();
+
+      if (res.size() > val + 2 && res[val] >= '0' && res[val] <= '9' &&
+        res[val + 1] == '$' && res[val + 2] == 'y')
+      {
+        state = res[val] - '0';
+      }
+    }
+
+    // the reply to the device attributes request, CSI ? params c,
+    // which comes last
+    for (auto i = res.find("\x1b[?"); i != std::string::npos; i = res.find("\x1b[?", i + 1))
+    {
+      auto j = i + 3;
+
+      while (j < res.size() && ((res[j] >= '0' && res[j] <= '9') || res[j] == ';'))
+      {
+        ++j;
+      }
+
+      if (j < res.size() && res[j] == 'c')
+      {
+        return state;
+      }
+    }
+
+    auto const left = std::chrono::duration_cast<std::chrono::milliseconds>(
+      end - std::chrono::steady_clock::now()).count();
+
+    if (left <= 0)
+    {
+      return state;
+    }
+
+    pollfd pfd {STDIN_FILENO, POLLIN, 0};
+
+    if (poll(&pfd, 1, static_cast<int>(left)) == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return state;
+    }
+
+    if (! (pfd.revents & POLLIN))
+    {
+      // the terminal went away
+      if (pfd.revents & (POLLHUP | POLLERR))
+      {
+        return state;
+      }
+
+      continue;
+    }
+
+    char buf[64];
+    auto const size = read(STDIN_FILENO, buf, sizeof(buf));
+
+    if (size <= 0)
+    {
+      if (size == -1 && (errno == EINTR || errno == EAGAIN))
+      {
+        continue;
+      }
+
+      return state;
+    }
+
+    res.append(buf, static_cast<std::size_t>(size));
+  }
+}
+
 namespace ANSI_Escape_Codes
 {
 
@@ -783,6 +900,11 @@ std::string const screen_push {esc + "[?1049h"};
 std::string const screen_pop {esc + "[?1049l"};
 std::string const screen_clear {esc + "[2J"};
 
+// synchronized output, the terminal shows what is output between
+// begin and end all at once
+std::string const sync_begin {esc + "[?2026h"};
+std::string const sync_end {esc + "[?2026l"};
+
 // scroll
 std::string const scroll_up {esc + "M"};
 std::string const scroll_down {esc + "D"};
@@ -846,32 +968,182 @@ std::string const bg_white_bright {esc + "[107m"};
 // box drawing
 // TODO add box drawing chars
 
+// an escape sequence in a fixed size inline buffer, built without allocating,
+// long enough for any sequence made by the builders below
+class Seq
+{
+public:
+
+  Seq& operator<<(char const ch)
+  {
+    if (_size < _buf.size())
+    {
+      _buf[_size++] = ch;
+    }
+
+    return *this;
+  }
+
+  Seq& operator<<(std::string_view const str)
+  {
+    auto const size = std::min(str.size(), _buf.size() - _size);
+    std::copy_n(str.data(), size, _buf.data() + _size);
+    _size += size;
+
+    return *this;
+  }
+
+  template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+  Seq& operator<<(T const val)
+  {
+    auto const res = std::to_chars(_buf.data() + _size, _buf.data() + _buf.size(), val);
+
+    if (res.ec == std::errc())
+    {
+      _size = static_cast<std::size_t>(res.ptr - _buf.data());
+    }
+
+    return *this;
+  }
+
+  std::string_view view() const
+  {
+    return {_buf.data(), _size};
+  }
+
+  operator std::string_view() const
+  {
+    return view();
+  }
+
+  std::string str() const
+  {
+    return std::string(view());
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, Seq const& obj)
+  {
+    return os << obj.view();
+  }
+
+private:
+
+  std::array<char, 48> _buf {};
+  std::size_t _size {0};
+}; // class Seq
+
+// builders that append a sequence to an output, any of std::ostream,
+// OB::Buffer, or Seq, without allocating
+template<typename T>
+using if_output = std::enable_if_t<! std::is_arithmetic_v<T>, int>;
+
+// compose the parts of a sequence inline, then append it in one piece
+template<typename T, typename... Args>
+T& put(T& out, Args const&... args)
+{
+  if constexpr (std::is_same_v<T, Seq>)
+  {
+    (out << ... << args);
+  }
+  else
+  {
+    Seq seq;
+    (seq << ... << args);
+    out << seq.view();
+  }
+
+  return out;
+}
+
+template<typename T, if_output<T> = 0>
+T& cursor_up(T& out, std::size_t val = 1)
+{
+  return val ? put(out, esc, '[', val, 'A') : out;
+}
+
+template<typename T, if_output<T> = 0>
+T& cursor_down(T& out, std::size_t val = 1)
+{
+  return val ? put(out, esc, '[', val, 'B') : out;
+}
+
+template<typename T, if_output<T> = 0>
+T& cursor_right(T& out, std::size_t val = 1)
+{
+  return val ? put(out, esc, '[', val, 'C') : out;
+}
+
+template<typename T, if_output<T> = 0>
+T& cursor_left(T& out, std::size_t val = 1)
+{
+  return val ? put(out, esc, '[', val, 'D') : out;
+}
+
+template<typename T, if_output<T> = 0>
+T& cursor_set(T& out, std::size_t x_, std::size_t y_)
+{
+  return put(out, esc, '[', y_, ';', x_, 'H');
+}
+
+// 256 colour palette index, range [0-255]
+template<typename T, if_output<T> = 0>
+T& fg_256(T& out, unsigned int const val)
+{
+  return put(out, esc, "[38;5;", val, 'm');
+}
+
+template<typename T, if_output<T> = 0>
+T& bg_256(T& out, unsigned int const val)
+{
+  return put(out, esc, "[48;5;", val, 'm');
+}
+
+// 24-bit colour, range [0-255] per channel
+template<typename T, if_output<T> = 0>
+T& fg_true(T& out, unsigned int const r, unsigned int const g, unsigned int const b)
+{
+  return put(out, esc, "[38;2;", r, ';', g, ';', b, 'm');
+}
+
+template<typename T, if_output<T> = 0>
+T& bg_true(T& out, unsigned int const r, unsigned int const g, unsigned int const b)
+{
+  return put(out, esc, "[48;2;", r, ';', g, ';', b, 'm');
+}
+
 inline std::string cursor_up(std::size_t val = 1)
 {
-  return val ? esc + "[" + std::to_string(val) + "A" : "";
+  Seq seq;
+
+  return cursor_up(seq, val).str();
 }
 
 inline std::string cursor_down(std::size_t val = 1)
 {
-  return val ? esc + "[" + std::to_string(val) + "B" : "";
+  Seq seq;
+
+  return cursor_down(seq, val).str();
 }
 
 inline std::string cursor_right(std::size_t val = 1)
 {
-  return val ? esc + "[" + std::to_string(val) + "C" : "";
+  Seq seq;
+
+  return cursor_right(seq, val).str();
 }
 
 inline std::string cursor_left(std::size_t val = 1)
 {
-  return val ? esc + "[" + std::to_string(val) + "D" : "";
+  Seq seq;
+
+  return cursor_left(seq, val).str();
 }
 
 inline std::string cursor_set(std::size_t x_, std::size_t y_)
 {
-  std::stringstream ss;
-  ss << esc << "[" << y_ << ";" << x_ << "H";
+  Seq seq;
 
-  return ss.str();
+  return cursor_set(seq, x_, y_).str();
 }
 
 inline int cursor_get(std::size_t& x_, std::size_t& y_, bool mode_ = true)
@@ -1117,54 +1389,71 @@ inline std::string fg_256(std::string const& str_)
 {
   auto const n = std::stoi(str_);
   if (n < 0 || n > 256) return {};
-  std::stringstream ss;
-  ss << esc << "[38;5;" << str_ << "m";
+  Seq seq;
+  seq << esc << "[38;5;" << str_ << 'm';
 
-  return ss.str();
+  return seq.str();
 }
 
 inline std::string bg_256(std::string const& str_)
 {
   auto const n = std::stoi(str_);
   if (n < 0 || n > 256) return {};
-  std::stringstream ss;
-  ss << esc << "[48;5;" << str_ << "m";
+  Seq seq;
+  seq << esc << "[48;5;" << str_ << 'm';
 
-  return ss.str();
+  return seq.str();
+}
+
+// value of a string of hex digits, -1 if it is empty or not hex
+inline int hex_to_int(std::string_view const str_)
+{
+  int n {0};
+  auto const res = std::from_chars(str_.data(), str_.data() + str_.size(), n, 16);
+
+  if (str_.empty() || str_.front() == '-' || res.ec != std::errc() ||
+    res.ptr != str_.data() + str_.size())
+  {
+    return -1;
+  }
+
+  return n;
 }
 
 inline std::string htoi(std::string const& str_)
 {
-  std::stringstream ss;
-  ss << str_;
-  unsigned int n;
-  ss >> std::hex >> n;
+  auto const n = hex_to_int(str_);
 
-  return std::to_string(n);
+  return std::to_string(n == -1 ? 0 : n);
 }
 
+// accepts an optional '#' followed by 3 or 6 hex digits,
+// on success str_ is set to the 6 digit form
 inline bool valid_hstr(std::string& str_)
 {
-  std::smatch m;
-  std::regex rx {"^#?((?:[0-9a-fA-F]{3}){1,2})$"};
+  std::string_view hstr {str_};
 
-  if (std::regex_match(str_, m, rx, std::regex_constants::match_not_null))
+  if (! hstr.empty() && hstr.front() == '#')
   {
-    std::string hstr {m[1]};
-
-    if (hstr.size() == 3)
-    {
-      std::stringstream ss;
-      ss << hstr[0] << hstr[0] << hstr[1] << hstr[1] << hstr[2] << hstr[2];
-      hstr = ss.str();
-    }
+    hstr.remove_prefix(1);
+  }
 
-    str_ = hstr;
+  if ((hstr.size() != 3 && hstr.size() != 6) ||
+    ! std::all_of(hstr.begin(), hstr.end(), [](unsigned char const c) { return std::isxdigit(c); }))
+  {
+    return false;
+  }
 
-    return true;
+  if (hstr.size() == 3)
+  {
+    str_ = {hstr[0], hstr[0], hstr[1], hstr[1], hstr[2], hstr[2]};
+  }
+  else
+  {
+    str_ = std::string(hstr);
   }
 
-  return false;
+  return true;
 }
 
 inline std::string fg_true(std::string str_)
@@ -1174,17 +1463,13 @@ inline std::string fg_true(std::string str_)
     return {};
   }
 
-  std::string const h1 {str_.substr(0, 2)};
-  std::string const h2 {str_.substr(2, 2)};
-  std::string const h3 {str_.substr(4, 2)};
-
-  std::ostringstream os; os
-  << esc << "[38;2;"
-  << htoi(h1) << ";"
-  << htoi(h2) << ";"
-  << htoi(h3) << "m";
+  auto const hex = std::string_view(str_);
+  Seq seq;
 
-  return os.str();
+  return fg_true(seq,
+    static_cast<unsigned int>(hex_to_int(hex.substr(0, 2))),
+    static_cast<unsigned int>(hex_to_int(hex.substr(2, 2))),
+    static_cast<unsigned int>(hex_to_int(hex.substr(4, 2)))).str();
 }
 
 inline std::string bg_true(std::string str_)
@@ -1194,17 +1479,13 @@ inline std::string bg_true(std::string str_)
     return {};
   }
 
-  std::string const h1 {str_.substr(0, 2)};
-  std::string const h2 {str_.substr(2, 2)};
-  std::string const h3 {str_.substr(4, 2)};
+  auto const hex = std::string_view(str_);
+  Seq seq;
 
-  std::stringstream ss; ss
-  << esc << "[48;2;"
-  << htoi(h1) << ";"
-  << htoi(h2) << ";"
-  << htoi(h3) << "m";
-
-  return ss.str();
+  return bg_true(seq,
+    static_cast<unsigned int>(hex_to_int(hex.substr(0, 2))),
+    static_cast<unsigned int>(hex_to_int(hex.substr(2, 2))),
+    static_cast<unsigned int>(hex_to_int(hex.substr(4, 2)))).str();
 }
 
 template<typename T>
@@ -0,0 +1,109 @@
+#ifndef OB_TIMER_HH
+#define OB_TIMER_HH
+
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+
+#include <chrono>
+
+namespace OB
+{
+
+// a one shot timer on the wall clock that is waited on as a file descriptor,
+// using timerfd, it also fires when the clock is set so the caller
+// can reschedule against the new time
+class Timer
+{
+public:
+
+  using clock = std::chrono::system_clock;
+
+  Timer() = default;
+
+  Timer(Timer const&) = delete;
+  Timer& operator=(Timer const&) = delete;
+
+  ~Timer()
+  {
+    close();
+  }
+
+  // returns false when timerfd is unavailable
+  bool open()
+  {
+    close();
+
+    _fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    return _fd != -1;
+  }
+
+  // fire at an absolute time, replacing any earlier time,
+  // a time in the past fires straight away
+  bool set(clock::time_point const time)
+  {
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      time.time_since_epoch()).count();
+
+    itimerspec val {};
+    val.it_value.tv_sec = static_cast<std::time_t>(ns / 1'000'000'000);
+    val.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+
+    // a zero value disarms the timer
+    if (val.it_value.tv_sec <= 0 && val.it_value.tv_nsec <= 0)
+    {
+      val.it_value.tv_nsec = 1;
+    }
+
+    return timerfd_settime(_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &val, nullptr) == 0;
+  }
+
+  // returns true if the timer fired or the clock was set since it was armed,
+  // never blocks
+  bool expired()
+  {
+    std::uint64_t count {0};
+
+    while (true)
+    {
+      if (read(_fd, &count, sizeof(count)) == sizeof(count))
+      {
+        return true;
+      }
+
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return errno == ECANCELED;
+    }
+  }
+
+  // file descriptor to wait on, -1 when closed
+  int fd() const
+  {
+    return _fd;
+  }
+
+  void close()
+  {
+    if (_fd != -1)
+    {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+private:
+
+  int _fd {-1};
+}; // class Timer
+
+} // namespace OB
+
+#endif // OB_TIMER_HH
@@ -8,6 +8,7 @@ using Rect = OB::Rect;
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
 #include <ctime>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
 
@@ -18,294 +19,486 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <chrono>
 #include <thread>
 #include <algorithm>
+#include <initializer_list>
 
-void Peaclock::init_ctx(std::size_t const width, std::size_t const height)
+void Peaclock::init_ctx(std::size_t const width, std::size_t const height,
+  std::time_t const time)
 {
-  _ctx = Ctx();
+  set_clock_value(time);
 
-  _ctx.width = width;
-  _ctx.height = height - 1;
+  // animated colours are computed once per frame from the elapsed time,
+  // so their speed is the same at any size or refresh rate,
+  // when animation is reduced they keep their last colour
+  if (_reduce < Reduce::animation)
+  {
+    auto const elapsed = _animation_time ?
+      std::chrono::duration<double, std::milli>(*_animation_time) :
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _epoch);
+    auto const phase = std::fmod(elapsed.count() / cfg.rate_animation.get(), 1.0);
+
+    // cfg.style.title.phase(phase);
+    cfg.style.date.phase(phase);
+    cfg.style.background.phase(phase);
+    cfg.style.active_fg.phase(phase);
+    cfg.style.inactive_fg.phase(phase);
+    cfg.style.colon_fg.phase(phase);
+    cfg.style.active_bg.phase(phase);
+    cfg.style.inactive_bg.phase(phase);
+    cfg.style.colon_bg.phase(phase);
+  }
+
+  if (_layout.generation != _generation ||
+    _layout.width != width || _layout.height != height - 1)
+  {
+    init_layout(width, height);
+  }
 
-  set_clock_value();
+  // set starting coordinates
+  _ctx.x = _layout.x_begin;
+  _ctx.y = _layout.y_begin;
+}
 
-  // cfg.style.title.step();
-  cfg.style.date.step();
-  cfg.style.background.step();
-  cfg.style.active_fg.step();
-  cfg.style.inactive_fg.step();
-  cfg.style.colon_fg.step();
-  cfg.style.active_bg.step();
-  cfg.style.inactive_bg.step();
-  cfg.style.colon_bg.step();
+void Peaclock::init_layout(std::size_t const width, std::size_t const height)
+{
+  _layout = Layout();
+  _layout.generation = _generation;
+
+  _layout.width = width;
+  _layout.height = height - 1;
 
   if (cfg.mode != Mode::date)
   {
     // set the buffer to a template
-    if (cfg.mode == Mode::digital)
-    {
-      _ctx.buffer = cfg.seconds ? _clock_digital_seconds : _clock_digital;
-    }
-    else if (cfg.mode == Mode::binary)
+    switch (cfg.mode)
     {
-      _ctx.buffer = cfg.seconds ? _clock_binary_seconds : _clock_binary;
-    }
-    else
-    {
-      _ctx.buffer = _icon;
-    }
+      case Mode::digital:
+      {
+        seconds() ? raster_init<Mode::digital, true>() : raster_init<Mode::digital, false>();
+
+        break;
+      }
+
+      case Mode::binary:
+      {
+        seconds() ? raster_init<Mode::binary, true>() : raster_init<Mode::binary, false>();
+
+        break;
+      }
 
-    _ctx.x_blocks = count_x_blocks(_ctx.buffer);
-    _ctx.y_blocks = count_y_blocks(_ctx.buffer);
+      case Mode::icon:
+      {
+        raster_init<Mode::icon, false>();
+
+        break;
+      }
+
+      default:
+      {
+        break;
+      }
+    }
 
-    _ctx.x_spaces = _ctx.x_blocks - 1;
-    _ctx.y_spaces = _ctx.y_blocks - 1;
+    _layout.x_spaces = _layout.x_blocks - 1;
+    _layout.y_spaces = _layout.y_blocks - 1;
 
     calc_xy_block();
     calc_xy_ratio();
     calc_xy_begin();
 
     // init block
-    _ctx.block.xy_max(_ctx.width + 1, _ctx.height + 1);
-    _ctx.block.wh(_ctx.x_block, _ctx.y_block);
-
-    // set starting coordinates
-    _ctx.x = _ctx.x_begin;
-    _ctx.y = _ctx.y_begin;
+    _ctx.block.xy_max(_layout.width + 1, _layout.height + 1);
+    _ctx.block.wh(_layout.x_block, _layout.y_block);
   }
 }
 
-void Peaclock::draw_background(std::size_t const width, std::size_t const height, std::ostringstream& buf)
+void Peaclock::draw_background(OB::Grid& grid)
 {
-  _ctx.background.xy_max(_ctx.width + 1, _ctx.height + 1);
+  _ctx.background.xy_max(_layout.width + 1, _layout.height + 1);
   _ctx.background.xy(0, 0);
-  _ctx.background.wh(_ctx.width, _ctx.height);
+  _ctx.background.wh(_layout.width, _layout.height);
   _ctx.background.color_bg(cfg.style.background);
 
-  buf << _ctx.background;
+  _ctx.background.draw(grid);
 }
 
-void Peaclock::draw_title(std::ostringstream& buf)
+void Peaclock::draw_title(OB::Grid& grid)
 {
   if (cfg.title && cfg.titlefmt.size())
   {
-    _ctx.title.xy_max(_ctx.width + 1, _ctx.height + 1);
+    _ctx.title.xy_max(_layout.width + 1, _layout.height + 1);
     _ctx.title.xy(0, _ctx.y);
-    _ctx.title.wh(_ctx.width, cfg.height_titlefmt);
+    _ctx.title.wh(_layout.width, cfg.height_titlefmt);
     _ctx.title.color_fg(cfg.style.title);
     _ctx.title.color_bg(cfg.style.background);
     _ctx.title.text(cfg.titlefmt);
     _ctx.title.align(Rect::Align::center, Rect::Align::top);
 
-    buf << _ctx.title;
+    _ctx.title.draw(grid);
 
     _ctx.y += 1 + cfg.height_titlefmt;
   }
 }
 
-void Peaclock::draw_clock(std::ostringstream& buf)
+Peaclock::Block Peaclock::block(int const type)
 {
-  if (cfg.mode != Mode::date)
+  switch (type)
   {
-    if (cfg.mode == Mode::digital)
+    case Type::on:
+    {
+      return {_ctx.fill_active, cfg.fill_active, cfg.style.active_fg,
+        stepped(cfg.style.active_bg) ?
+        cfg.style.active_bg.step() : cfg.style.active_bg.key() == "clear" ?
+        cfg.style.background : cfg.style.active_bg,
+        ! stepped(cfg.style.active_bg)};
+    }
+
+    case Type::colon:
     {
-      set_clock_digital();
+      return {_ctx.fill_colon, cfg.fill_colon, cfg.style.colon_fg,
+        stepped(cfg.style.colon_bg) ?
+        cfg.style.colon_bg.step() : cfg.style.colon_bg.key() == "clear" ?
+        cfg.style.active_bg : cfg.style.colon_bg,
+        ! stepped(cfg.style.colon_bg)};
     }
-    else if (cfg.mode == Mode::binary)
+
+    case Type::off:
+    default:
     {
-      set_clock_binary();
+      return {_ctx.fill_inactive, cfg.fill_inactive, cfg.style.inactive_fg,
+        stepped(cfg.style.inactive_bg) ?
+        cfg.style.inactive_bg.step() : cfg.style.inactive_bg.key() == "clear" ?
+        cfg.style.background : cfg.style.inactive_bg,
+        ! stepped(cfg.style.inactive_bg)};
     }
+  }
+}
+
+bool Peaclock::stepped(OB::Color const& color) const
+{
+  return _reduce < Reduce::animation &&
+    (color.mode() == OB::Color::Mode::party || color.mode() == OB::Color::Mode::candy);
+}
+
+void Peaclock::draw_clock(OB::Grid& grid)
+{
+  if (cfg.mode != Mode::date)
+  {
+    set_clock();
+
+    auto const x_space = cfg.x_space.get();
+    auto const x_step = _layout.x_block + x_space;
+    auto const background = grid.style(cfg.style.background.value());
+    std::string const spaces;
 
     // draw blocks
-    for (std::size_t i = 0; i < _ctx.buffer.size(); ++i)
+    for (std::size_t row = 0; row < _layout.y_blocks; ++row)
     {
-      auto const type = _ctx.buffer.at(i);
+      auto const* const line = &_layout.buffer[row * _layout.x_blocks];
 
-      switch (type)
+      for (std::size_t col = 0; col < _layout.x_blocks;)
       {
-        case Type::empty:
+        auto const type = line[col];
+
+        if (type == Type::empty)
         {
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
+          _ctx.x += x_step;
+          ++col;
 
-          break;
+          continue;
         }
 
-        case Type::off:
-        {
-          _ctx.block.xy(_ctx.x, _ctx.y);
-          _ctx.block.text("");
-          _ctx.block.align(Rect::Align::center, Rect::Align::center);
-
-          _ctx.block.color_fg(cfg.style.inactive_fg);
-          _ctx.block.color_bg(
-            cfg.style.inactive_bg.mode() == OB::Color::Mode::party ||
-            cfg.style.inactive_bg.mode() == OB::Color::Mode::candy ?
-            cfg.style.inactive_bg.step() : cfg.style.inactive_bg.key() == "clear" ?
-            cfg.style.background : cfg.style.inactive_bg);
-
-          if (! cfg.fill_inactive.empty())
-          {
-            _ctx.block.text(OB::String::repeat(_ctx.y_block,
-              OB::String::repeat(_ctx.x_block, cfg.fill_inactive)
-              .substr(0, _ctx.x_block) + "\n"));
-          }
+        auto const blk = block(type);
 
-          buf << _ctx.block;
+        // spaces still show a block that stands out by its background
+        auto const& str = _reduce >= Reduce::fill && blk.bg.key() != "clear" &&
+          blk.bg.value() != cfg.style.background.value() ? spaces : blk.str;
 
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
+        // blocks with text or animated colours are drawn one at a time
+        if (! str.empty() || ! blk.solid || blk.fg.mode() != OB::Color::Mode::null)
+        {
+          draw_block(grid, blk.fill, str, blk.fg, blk.bg);
+          _ctx.x += x_step;
+          ++col;
 
-          break;
+          continue;
         }
 
-        case Type::on:
+        auto const fg = grid.style(blk.fg.value());
+        auto const bg = grid.style(blk.bg.value());
+
+        // coalesce the run of identical blocks into a single fill,
+        // the gaps between them join the run when they share the background
+        std::size_t run {1};
+
+        if (x_space == 0 || bg == background)
         {
-          _ctx.block.xy(_ctx.x, _ctx.y);
-          _ctx.block.text("");
-          _ctx.block.align(Rect::Align::center, Rect::Align::center);
-
-          _ctx.block.color_fg(cfg.style.active_fg);
-          _ctx.block.color_bg(
-            cfg.style.active_bg.mode() == OB::Color::Mode::party ||
-            cfg.style.active_bg.mode() == OB::Color::Mode::candy ?
-            cfg.style.active_bg.step() : cfg.style.active_bg.key() == "clear" ?
-            cfg.style.background : cfg.style.active_bg);
-
-          if (! cfg.fill_active.empty())
+          while (col + run < _layout.x_blocks && line[col + run] == type)
           {
-            _ctx.block.text(OB::String::repeat(_ctx.y_block,
-              OB::String::repeat(_ctx.x_block, cfg.fill_active)
-              .substr(0, _ctx.x_block) + "\n"));
+            ++run;
           }
+        }
+
+        // transparent blocks leave the background untouched
+        if (blk.bg.key() != "clear")
+        {
+          grid.fill(_ctx.x, _ctx.y, (run * x_step) - x_space, _layout.y_block, " ", fg, bg);
+        }
 
-          buf << _ctx.block;
+        _ctx.x += run * x_step;
+        col += run;
+      }
 
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
+      _ctx.x = _layout.x_begin;
+      _ctx.y += _layout.y_block + cfg.y_space.get();
+    }
+  }
+}
 
-          break;
-        }
+void Peaclock::draw_block(OB::Grid& grid, Ctx::Fill& fill, std::string const& str,
+  OB::Color const& fg, OB::Color const& bg)
+{
+  // party colours change with every grapheme and can not be pre-rendered
+  if (str.empty() || fg.mode() == OB::Color::Mode::party)
+  {
+    _ctx.block.xy(_ctx.x, _ctx.y);
+    _ctx.block.align(Rect::Align::center, Rect::Align::center);
+    _ctx.block.color_fg(fg);
+    _ctx.block.color_bg(bg);
 
-        case Type::colon:
-        {
-          _ctx.block.xy(_ctx.x, _ctx.y);
-          _ctx.block.text("");
-          _ctx.block.align(Rect::Align::center, Rect::Align::center);
-
-          _ctx.block.color_fg(cfg.style.colon_fg);
-          _ctx.block.color_bg(
-            cfg.style.colon_bg.mode() == OB::Color::Mode::party ||
-            cfg.style.colon_bg.mode() == OB::Color::Mode::candy ?
-            cfg.style.colon_bg.step() : cfg.style.colon_bg.key() == "clear" ?
-            cfg.style.active_bg : cfg.style.colon_bg);
-
-          if (! cfg.fill_colon.empty())
-          {
-            _ctx.block.text(OB::String::repeat(_ctx.y_block,
-              OB::String::repeat(_ctx.x_block, cfg.fill_colon)
-              .substr(0, _ctx.x_block) + "\n"));
-          }
+    if (str.empty())
+    {
+      _ctx.block.text("");
+    }
+    else
+    {
+      _ctx.block.text(OB::String::repeat(_layout.y_block,
+        OB::String::repeat(_layout.x_block, str)
+        .substr(0, _layout.x_block) + "\n"));
+    }
 
-          buf << _ctx.block;
+    _ctx.block.draw(grid);
 
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
+    return;
+  }
 
-          break;
-        }
+  auto const style_fg = grid.style(fg.value());
+  auto const style_bg = grid.style(bg.value());
 
-        case Type::newline:
-        {
-          _ctx.x = _ctx.x_begin;
-          _ctx.y += _ctx.y_block + cfg.y_space.get();
+  if (fill.width != _layout.x_block || fill.str != str)
+  {
+    // every row of the block holds the same line, centered like OB::Rect text
+    fill.width = _layout.x_block;
+    fill.str = str;
+    fill.fg = style_fg;
+    fill.bg = style_bg;
+    fill.cells.clear();
 
-          break;
-        }
+    std::string const line {OB::String::repeat(fill.width, str).substr(0, fill.width)};
+    OB::Text::View lnv {line};
 
-        default:
-        {
-          break;
-        }
+    auto const tcols = lnv.cols();
+    fill.offset = fill.width / 2 >= tcols / 2 ? fill.width / 2 - tcols / 2 : 0;
+
+    auto const push = [&](std::string_view const val, std::size_t const cols) {
+      fill.cells.push_back({std::string(val), style_fg, style_bg});
+
+      if (cols == 2)
+      {
+        fill.cells.push_back({"", style_fg, style_bg});
+      }
+    };
+
+    if (tcols <= fill.width)
+    {
+      lnv.str(lnv.colstr(0, fill.width));
+
+      for (auto const& e : lnv)
+      {
+        push(e.str, e.cols);
       }
     }
+    else
+    {
+      lnv.str(lnv.colstr(0, fill.width - 1));
+
+      for (auto const& e : lnv)
+      {
+        push(e.str, e.cols);
+      }
+
+      while (fill.offset + fill.cells.size() + 1 < fill.width)
+      {
+        push(" ", 1);
+      }
+
+      push(">", 1);
+    }
+  }
+  else if (fill.fg != style_fg || fill.bg != style_bg)
+  {
+    fill.fg = style_fg;
+    fill.bg = style_bg;
+
+    for (auto& e : fill.cells)
+    {
+      e.fg = style_fg;
+      e.bg = style_bg;
+    }
+  }
+
+  for (std::size_t row = 0; row < _layout.y_block; ++row)
+  {
+    grid.put(_ctx.x + fill.offset, _ctx.y + row, fill.cells);
   }
 }
 
-void Peaclock::draw_date(std::ostringstream& buf)
+void Peaclock::draw_date(OB::Grid& grid)
 {
   if (cfg.date && cfg.datefmt.size())
   {
-    _ctx.date.xy_max(_ctx.width + 1, _ctx.height + 1);
-    _ctx.date.xy(0, (cfg.mode != Mode::date ? (_ctx.y += 1 - cfg.y_space.get(), _ctx.y) : _ctx.height / 2));
-    _ctx.date.wh(_ctx.width, cfg.height_datefmt);
+    _ctx.date.xy_max(_layout.width + 1, _layout.height + 1);
+    _ctx.date.xy(0, (cfg.mode != Mode::date ? (_ctx.y += 1 - cfg.y_space.get(), _ctx.y) : _layout.height / 2));
+    _ctx.date.wh(_layout.width, cfg.height_datefmt);
     _ctx.date.color_fg(cfg.style.date);
     _ctx.date.color_bg(cfg.style.background);
     _ctx.date.text(_ctx.datefmt);
     _ctx.date.align(Rect::Align::center, Rect::Align::top);
 
-    buf << _ctx.date;
+    _ctx.date.draw(grid);
   }
 }
 
-void Peaclock::render(std::size_t const width, std::size_t const height, std::ostringstream& buf)
+void Peaclock::render(std::size_t const width, std::size_t const height, OB::Grid& grid)
 {
-  init_ctx(width, height);
+  render(width, height, grid, std::time(nullptr));
+}
 
-  // draw_background(width, height, buf);
-  // draw_title(buf);
-  draw_clock(buf);
-  draw_date(buf);
+void Peaclock::render(std::size_t const width, std::size_t const height, OB::Grid& grid,
+  std::time_t const time)
+{
+  layout(width, height, time);
+  draw(grid);
 }
 
-std::size_t Peaclock::find(Peaclock::Clock const& vec, int const val, std::size_t const pos) const
+void Peaclock::layout(std::size_t const width, std::size_t const height, std::time_t const time)
 {
-  auto const res = std::find(vec.begin() + static_cast<long int>(pos), vec.end(), val);
+  init_ctx(width, height, time);
+}
 
-  return res != vec.end() ? static_cast<std::size_t>(std::distance(vec.begin(), res)) : npos;
+void Peaclock::draw(OB::Grid& grid)
+{
+  // draw_background(grid);
+  // draw_title(grid);
+  draw_clock(grid);
+  draw_date(grid);
 }
 
-std::size_t Peaclock::count(Clock const& vec, int const val) const
+std::time_t Peaclock::next_change(std::time_t const time) const
 {
-  std::size_t pos {0};
-  std::size_t count {0};
+  // smallest unit of time that is shown
+  enum {second, minute, day} unit {day};
 
-  for (;;)
+  if (cfg.mode == Mode::digital || cfg.mode == Mode::binary)
   {
-    pos = find(vec, val, pos);
+    unit = seconds() ? second : minute;
+  }
 
-    if (pos == npos)
+  if (cfg.date && unit != second)
+  {
+    for (std::size_t i = 0; i + 1 < cfg.datefmt.size(); ++i)
     {
-      break;
-    }
+      if (cfg.datefmt[i] != '%')
+      {
+        continue;
+      }
 
-    ++count;
-    ++pos;
-  }
+      // skip the alternative representation modifiers
+      if ((cfg.datefmt[++i] == 'E' || cfg.datefmt[i] == 'O') && i + 1 < cfg.datefmt.size())
+      {
+        ++i;
+      }
 
-  return count;
-}
+      switch (cfg.datefmt[i])
+      {
+        case 'S': case 'T': case 'X': case 'c': case 'r': case 's':
+        {
+          unit = second;
 
-std::size_t Peaclock::count_x_blocks(Clock const& clock) const
-{
-  auto pos = find(clock, 2);
+          break;
+        }
 
-  if (pos == npos)
-  {
-    pos = clock.size();
+        // hours and the timezone change on a minute boundary
+        case 'M': case 'R': case 'H': case 'I': case 'k': case 'l':
+        case 'p': case 'P': case 'z': case 'Z':
+        {
+          unit = minute;
+
+          break;
+        }
+
+        default:
+        {
+          break;
+        }
+      }
+
+      if (unit == second)
+      {
+        break;
+      }
+    }
   }
 
-  std::size_t count {0};
+  std::tm tm {*std::localtime(&time)};
+  auto const next_minute = std::max(time - tm.tm_sec + 60, time + 1);
 
-  for (std::size_t i = 0; i < pos; ++i)
+  switch (unit)
   {
-    if (clock.at(i) == -1 || clock.at(i) == 0 || clock.at(i) == 1)
+    case second:
     {
-      ++count;
+      return time + 1;
+    }
+
+    case minute:
+    {
+      return next_minute;
     }
-  }
 
-  return count;
+    case day:
+    default:
+    {
+      // the next midnight, let mktime resolve the end of the month and dst
+      tm.tm_sec = 0;
+      tm.tm_min = 0;
+      tm.tm_hour = 0;
+      ++tm.tm_mday;
+      tm.tm_isdst = -1;
+
+      auto const next = std::mktime(&tm);
+
+      return next > time ? next : next_minute;
+    }
+  }
 }
 
-std::size_t Peaclock::count_y_blocks(Clock const& clock) const
+bool Peaclock::animated() const
 {
-  return count(clock, 2);
+  if (_reduce >= Reduce::animation)
+  {
+    return false;
+  }
+
+  for (auto const* e : {&cfg.style.date, &cfg.style.background,
+    &cfg.style.active_fg, &cfg.style.inactive_fg, &cfg.style.colon_fg,
+    &cfg.style.active_bg, &cfg.style.inactive_bg, &cfg.style.colon_bg})
+  {
+    if (e->mode() != OB::Color::Mode::null)
+    {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 void Peaclock::extract_digits(int const num, int& t0, int& t1) const
@@ -324,37 +517,37 @@ void Peaclock::extract_digits(int const num, int& t0, int& t1) const
 
 void Peaclock::calc_xy_block()
 {
-  if (auto const val = (_ctx.width - (cfg.x_space.get() * _ctx.x_spaces) -
-    (cfg.x_border.get() * 2)) / _ctx.x_blocks;
+  if (auto const val = (_layout.width - (cfg.x_space.get() * _layout.x_spaces) -
+    (cfg.x_border.get() * 2)) / _layout.x_blocks;
     static_cast<int>(val) > 0)
   {
-    _ctx.x_block = val;
+    _layout.x_block = val;
   }
   else
   {
-    _ctx.x_block = 1;
+    _layout.x_block = 1;
   }
 
-  if (! cfg.auto_size && (_ctx.x_block > cfg.x_block.get()))
+  if (! cfg.auto_size && (_layout.x_block > cfg.x_block.get()))
   {
-    _ctx.x_block = cfg.x_block.get();
+    _layout.x_block = cfg.x_block.get();
   }
 
-  if (auto const val = (_ctx.height - (cfg.y_space.get() * _ctx.y_spaces) - (cfg.y_border.get() * 2) -
+  if (auto const val = (_layout.height - (cfg.y_space.get() * _layout.y_spaces) - (cfg.y_border.get() * 2) -
     (cfg.title && cfg.height_titlefmt ? cfg.height_titlefmt + 1 : 0) -
-    (cfg.date && cfg.height_datefmt ? cfg.height_datefmt + 1 : 0)) / _ctx.y_blocks;
+    (cfg.date && cfg.height_datefmt ? cfg.height_datefmt + 1 : 0)) / _layout.y_blocks;
     static_cast<int>(val) > 0)
   {
-    _ctx.y_block = val;
+    _layout.y_block = val;
   }
   else
   {
-    _ctx.y_block = 1;
+    _layout.y_block = 1;
   }
 
-  if (! cfg.auto_size && (_ctx.y_block > cfg.y_block.get()))
+  if (! cfg.auto_size && (_layout.y_block > cfg.y_block.get()))
   {
-    _ctx.y_block = cfg.y_block.get();
+    _layout.y_block = cfg.y_block.get();
   }
 }
 
@@ -362,146 +555,140 @@ void Peaclock::calc_xy_ratio()
 {
   if (cfg.auto_ratio)
   {
-    if (_ctx.x_block > cfg.x_ratio.get())
+    if (_layout.x_block > cfg.x_ratio.get())
     {
-      _ctx.x_block -= _ctx.x_block % cfg.x_ratio.get();
+      _layout.x_block -= _layout.x_block % cfg.x_ratio.get();
     }
 
-    if (_ctx.y_block > cfg.y_ratio.get())
+    if (_layout.y_block > cfg.y_ratio.get())
     {
-      _ctx.y_block -= _ctx.y_block % cfg.y_ratio.get();
+      _layout.y_block -= _layout.y_block % cfg.y_ratio.get();
     }
 
     if (cfg.x_ratio.get() > cfg.y_ratio.get())
     {
-      if (auto const val = _ctx.x_block * (cfg.y_ratio.get() /
+      if (auto const val = _layout.x_block * (cfg.y_ratio.get() /
         static_cast<double>(cfg.x_ratio.get()));
-        val <= _ctx.y_block)
+        val <= _layout.y_block)
       {
-        _ctx.y_block = val;
+        _layout.y_block = val;
       }
       else
       {
-        _ctx.x_block = _ctx.y_block * (cfg.x_ratio.get() /
+        _layout.x_block = _layout.y_block * (cfg.x_ratio.get() /
           static_cast<double>(cfg.y_ratio.get()));
       }
     }
     else if (cfg.x_ratio.get() < cfg.y_ratio.get())
     {
-      if (auto const val = _ctx.y_block * (cfg.x_ratio.get() /
+      if (auto const val = _layout.y_block * (cfg.x_ratio.get() /
         static_cast<double>(cfg.y_ratio.get()));
-        val <= _ctx.x_block)
+        val <= _layout.x_block)
       {
-        _ctx.x_block = val;
+        _layout.x_block = val;
       }
       else
       {
-        _ctx.y_block = _ctx.x_block * (cfg.y_ratio.get() /
+        _layout.y_block = _layout.x_block * (cfg.y_ratio.get() /
           static_cast<double>(cfg.x_ratio.get()));
       }
     }
-    else if (_ctx.x_block != _ctx.y_block)
+    else if (_layout.x_block != _layout.y_block)
     {
-      if (_ctx.x_block > _ctx.y_block)
+      if (_layout.x_block > _layout.y_block)
       {
-        _ctx.x_block = _ctx.y_block;
+        _layout.x_block = _layout.y_block;
       }
       else
       {
-        _ctx.y_block = _ctx.x_block;
+        _layout.y_block = _layout.x_block;
       }
     }
 
-    if (_ctx.x_block < 1)
+    if (_layout.x_block < 1)
     {
-      _ctx.x_block = 1;
+      _layout.x_block = 1;
     }
 
-    if (_ctx.y_block < 1)
+    if (_layout.y_block < 1)
     {
-      _ctx.y_block = 1;
+      _layout.y_block = 1;
     }
   }
 }
 
 void Peaclock::calc_xy_begin()
 {
-  if (auto const val = ((_ctx.x_block * _ctx.x_blocks) + (cfg.x_space.get() *
-    _ctx.x_spaces)) / 2;
-    val < _ctx.width / 2)
+  if (auto const val = ((_layout.x_block * _layout.x_blocks) + (cfg.x_space.get() *
+    _layout.x_spaces)) / 2;
+    val < _layout.width / 2)
   {
-    _ctx.x_begin = (_ctx.width / 2) - val;
+    _layout.x_begin = (_layout.width / 2) - val;
   }
   else
   {
-    _ctx.x_begin = 0;
+    _layout.x_begin = 0;
   }
 
-  if (auto const val = ((_ctx.y_block * _ctx.y_blocks) + (cfg.y_space.get() * _ctx.y_spaces) +
+  if (auto const val = ((_layout.y_block * _layout.y_blocks) + (cfg.y_space.get() * _layout.y_spaces) +
     (cfg.title && cfg.height_titlefmt ? cfg.height_titlefmt + 1 : 0) +
     (cfg.date && cfg.height_datefmt ? cfg.height_datefmt + 1 : 0)) / 2;
-    val < _ctx.height / 2)
+    val < _layout.height / 2)
   {
-    _ctx.y_begin = (_ctx.height / 2) - val;
+    _layout.y_begin = (_layout.height / 2) - val;
   }
   else
   {
-    _ctx.y_begin = 0;
+    _layout.y_begin = 0;
   }
 }
 
-void Peaclock::fill_digital(std::size_t width, std::size_t begin, std::size_t end, Position::Type type)
+void Peaclock::cfg_changed()
 {
-  for (std::size_t i = 0, j = 0; i < 5; ++i)
-  {
-    for (std::size_t k = begin; k < end; ++j, ++k)
-    {
-      _ctx.buffer.at(k + (width * i)) = _symbol.at(static_cast<std::size_t>(_ctx.value.at(type))).at(j);
-    }
-  }
+  ++_generation;
 }
 
-void Peaclock::fill_binary(std::size_t width, std::size_t col, int num)
+void Peaclock::reduce(Reduce::Type const val)
 {
-  if (num >= 8)
+  if (_reduce != val)
   {
-    num -= 8;
-    _ctx.buffer.at(col + (0 * width)) = 1;
+    _reduce = val;
+    cfg_changed();
   }
+}
 
-  if (num >= 4)
-  {
-    num -= 4;
-    _ctx.buffer.at(col + (1 * width)) = 1;
-  }
+Peaclock::Reduce::Type Peaclock::reduce() const
+{
+  return _reduce;
+}
 
-  if (num >= 2)
-  {
-    num -= 2;
-    _ctx.buffer.at(col + (2 * width)) = 1;
-  }
+void Peaclock::animation_time(std::chrono::milliseconds const val)
+{
+  _animation_time = val;
+}
 
-  if (num == 1)
-  {
-    --num;
-    _ctx.buffer.at(col + (3 * width)) = 1;
-  }
+bool Peaclock::seconds() const
+{
+  return cfg.seconds && _reduce < Reduce::seconds;
 }
 
 void Peaclock::cfg_titlefmt(std::string const& str)
 {
+  cfg_changed();
   cfg.titlefmt = str;
   cfg.height_titlefmt = OB::String::count(cfg.titlefmt, "\n") + (cfg.titlefmt.size() ? 1 : 0);
 }
 
 void Peaclock::cfg_datefmt(std::string const& str)
 {
+  cfg_changed();
   cfg.datefmt = str;
   cfg.height_datefmt = OB::String::count(cfg.datefmt, "\n") + (cfg.datefmt.size() ? 1 : 0);
 }
 
 bool Peaclock::cfg_timezone(std::string const& tz)
 {
+  cfg_changed();
   cfg.timezone = tz;
 
   return cfg.timezone.empty() ?
@@ -511,6 +698,8 @@ bool Peaclock::cfg_timezone(std::string const& tz)
 
 bool Peaclock::cfg_locale(std::string const& lc)
 {
+  cfg_changed();
+
   try
   {
     auto const tmp = std::locale(lc);
@@ -526,11 +715,9 @@ bool Peaclock::cfg_locale(std::string const& lc)
   return true;
 }
 
-void Peaclock::set_clock_value()
+void Peaclock::set_clock_value(std::time_t const time)
 {
-  // get the current time
-  std::time_t time_raw {std::time(nullptr)};
-  std::tm time_now {*std::localtime(&time_raw)};
+  std::tm time_now {*std::localtime(&time)};
 
   // set 12 or 24 hour time
   int hour {time_now.tm_hour};
@@ -576,38 +763,118 @@ void Peaclock::set_date(std::tm const& time_now)
   _ctx.datefmt = os.str();
 }
 
-void Peaclock::set_clock_digital()
+template<Peaclock::Mode::Type mode, bool seconds>
+void Peaclock::raster_init()
 {
-  std::size_t const row_len {cfg.seconds ? 28ul : 18ul};
+  using shape = Shape<mode, seconds>;
 
-  fill_digital(row_len, 0, 3, Position::H);
-  fill_digital(row_len, 4, 7, Position::h);
-  fill_digital(row_len, 10, 13, Position::M);
-  fill_digital(row_len, 10, 13, Position::M);
-  fill_digital(row_len, 14, 17, Position::m);
+  _layout.x_blocks = shape::x;
+  _layout.y_blocks = shape::y;
 
-  if (cfg.seconds)
+  auto& buf = _layout.buffer;
+
+  if constexpr (mode == Mode::digital)
   {
-    fill_digital(row_len, 20, 23, Position::S);
-    fill_digital(row_len, 24, 27, Position::s);
+    // digits are written each frame, only the colons are static
+    for (std::size_t i = 0; i < shape::x * shape::y; ++i)
+    {
+      buf[i] = Type::off;
+    }
+
+    for (std::size_t i = 0; i < (seconds ? 2 : 1); ++i)
+    {
+      buf[_digital_colon[i] + (1 * shape::x)] = Type::colon;
+      buf[_digital_colon[i] + (3 * shape::x)] = Type::colon;
+    }
+  }
+  else if constexpr (mode == Mode::binary)
+  {
+    for (std::size_t col = 0; col < shape::x; ++col)
+    {
+      // in 12 hour time the hour tens digit is at most 1
+      std::size_t const bits {col == Position::H && ! cfg.hour_24 ? 1 : _binary_bits[col]};
+
+      for (std::size_t row = 0; row < shape::y; ++row)
+      {
+        buf[col + (row * shape::x)] = row + bits < shape::y ? Type::empty : Type::off;
+      }
+    }
+  }
+  else if constexpr (mode == Mode::icon)
+  {
+    for (std::size_t row = 0; row < shape::y; ++row)
+    {
+      for (std::size_t col = 0; col < shape::x; ++col)
+      {
+        buf[col + (row * shape::x)] = (_icon[row] >> (shape::x - 1 - col)) & 1;
+      }
+    }
   }
 }
 
-void Peaclock::set_clock_binary()
+template<Peaclock::Mode::Type mode, bool seconds>
+void Peaclock::raster_value()
 {
-  std::size_t const row_len {cfg.seconds ? 6ul : 4ul};
+  using shape = Shape<mode, seconds>;
+
+  auto& buf = _layout.buffer;
 
-  if (cfg.hour_24)
+  if constexpr (mode == Mode::digital)
   {
-    _ctx.buffer.at(0 + (2 * (row_len + 1))) = 0;
+    for (std::size_t pos = 0; pos < (seconds ? 6 : 4); ++pos)
+    {
+      auto const glyph = _symbol[_ctx.value[pos]];
+      auto const begin = _digital_col[pos];
+
+      for (std::size_t row = 0; row < 5; ++row)
+      {
+        for (std::size_t col = 0; col < 3; ++col)
+        {
+          buf[begin + col + (row * shape::x)] = (glyph >> (14 - (row * 3) - col)) & 1;
+        }
+      }
+    }
   }
-  else
+  else if constexpr (mode == Mode::binary)
   {
-    _ctx.buffer.at(0 + (2 * (row_len + 1))) = -1;
+    for (std::size_t col = 0; col < shape::x; ++col)
+    {
+      auto const num = _ctx.value[col];
+
+      for (std::size_t row = 0; row < shape::y; ++row)
+      {
+        auto& block = buf[col + (row * shape::x)];
+
+        if (block != Type::empty)
+        {
+          block = (num >> (shape::y - 1 - row)) & 1;
+        }
+      }
+    }
   }
+}
 
-  for (std::size_t col {0}; col < row_len; ++col)
+void Peaclock::set_clock()
+{
+  switch (cfg.mode)
   {
-    fill_binary(row_len + 1, col, _ctx.value.at(col));
+    case Mode::digital:
+    {
+      seconds() ? raster_value<Mode::digital, true>() : raster_value<Mode::digital, false>();
+
+      break;
+    }
+
+    case Mode::binary:
+    {
+      seconds() ? raster_value<Mode::binary, true>() : raster_value<Mode::binary, false>();
+
+      break;
+    }
+
+    default:
+    {
+      break;
+    }
   }
 }
@@ -6,12 +6,18 @@ using Rect = OB::Rect;
 
 #include "ob/num.hh"
 #include "ob/color.hh"
+#include "ob/grid.hh"
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
 #include <ctime>
 #include <cstddef>
+#include <cstdint>
 
+#include <array>
+#include <chrono>
+#include <limits>
+#include <optional>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -20,7 +26,22 @@ class Peaclock
 {
 public:
 
-  void render(std::size_t const width, std::size_t const height, std::ostringstream& buf);
+  void render(std::size_t const width, std::size_t const height, OB::Grid& grid);
+
+  // render the clock at a fixed time instead of the current time
+  void render(std::size_t const width, std::size_t const height, OB::Grid& grid,
+    std::time_t const time);
+
+  // the two stages of render, update the clock value and layout, then draw
+  void layout(std::size_t const width, std::size_t const height, std::time_t const time);
+  void draw(OB::Grid& grid);
+
+  // the first time after time that the rendered clock or date changes,
+  // not counting animated colours
+  std::time_t next_change(std::time_t const time) const;
+
+  // a colour is animated, so the output changes on every frame
+  bool animated() const;
 
   struct Mode
   {
@@ -290,6 +311,9 @@ public:
     OB::num_size x_space {0, 0, 64};
     OB::num_size y_space {0, 0, 64};
 
+    // milliseconds for the animated colour modes to complete a cycle
+    OB::num rate_animation {500000, 100, 3600000};
+
     std::size_t height_titlefmt {0};
     std::size_t height_datefmt {1};
 
@@ -323,6 +347,32 @@ public:
   bool cfg_locale(std::string const& lc);
   bool cfg_timezone(std::string const& tz);
 
+  // must be called after modifying cfg directly
+  void cfg_changed();
+
+  // what is left out of the output for a slow terminal, without changing cfg,
+  // from least to most noticeable, each one includes the ones before it
+  struct Reduce
+  {
+    enum Type
+    {
+      none = 0,
+      // colours stop animating
+      animation,
+      // the seconds blocks are hidden
+      seconds,
+      // blocks that stand out by their background are filled with spaces
+      fill,
+    };
+  };
+
+  void reduce(Reduce::Type const val);
+  Reduce::Type reduce() const;
+
+  // animate the colours as if they had run for a fixed time,
+  // so the output is reproducible
+  void animation_time(std::chrono::milliseconds const val);
+
 private:
 
   struct Position
@@ -345,98 +395,86 @@ private:
       empty = -1,
       off = 0,
       on = 1,
-      newline = 2,
       colon = 3,
     };
   };
 
-  using Clock = std::vector<int>;
-
-  std::vector<Clock> const _symbol
+  // 3 x 5 digit glyphs, one bit per block in row major order,
+  // the most significant bit is the top left block
+  static std::uint16_t constexpr _symbol[]
   {
-    // 3 x 5
-    {1, 1, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 1, 1}, // 0
-    {0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0}, // 1
-    {1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1}, // 2
-    {1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1}, // 3
-    {1, 0, 1, 1, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 1}, // 4
-    {1, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 1}, // 5
-    {1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 1, 1, 1, 1}, // 6
-    {1, 1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1}, // 7
-    {1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1}, // 8
-    {1, 1, 1, 1, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 1}, // 9
+    0b111'101'101'101'111, // 0
+    0b010'010'010'010'010, // 1
+    0b111'001'111'100'111, // 2
+    0b111'001'111'001'111, // 3
+    0b101'101'111'001'001, // 4
+    0b111'100'111'001'111, // 5
+    0b111'100'111'101'111, // 6
+    0b111'001'001'001'001, // 7
+    0b111'101'111'101'111, // 8
+    0b111'101'111'001'001, // 9
   };
 
-  Clock const _icon
+  // 32 x 18 icon, one row per value, the most significant bit is the left block
+  static std::uint32_t constexpr _icon[]
   {
-    0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,0,0,1,1,1,1,1,1,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,1,1,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,0,0,1,1,1,1,1,1,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,2,
-    0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,2,
-    0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,2,
-    0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,2,
-    1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,2,
-    0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,2,
-    0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,2,
-    0,0,0,1,1,1,1,1,1,0,0,1,1,1,1,1,1,1,1,1,1,0,0,1,1,1,1,1,1,0,0,0,2,
-    0,0,0,1,1,1,0,0,0,0,0,1,1,1,1,0,0,1,1,1,1,0,0,0,0,0,1,1,1,0,0,0,2,
-    0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,2,
+    0b00000000'00001111'11110000'00000000,
+    0b00000000'00111111'11111100'00000000,
+    0b00000000'01111111'11111110'00000000,
+    0b00000000'11111111'11111111'00000000,
+    0b00000001'11111111'11111111'10000000,
+    0b00000011'11110011'11001111'11000000,
+    0b00000011'11100001'10000111'11000000,
+    0b00000011'11110011'11001111'11000000,
+    0b00000011'11111111'11111111'11000000,
+    0b00000011'11111111'11111111'11000000,
+    0b00000111'11111111'11111111'11100000,
+    0b00111111'11111111'11111111'11111100,
+    0b11111111'11111111'11111111'11111111,
+    0b00000011'11111111'11111111'11000000,
+    0b00001111'11111111'11111111'11110000,
+    0b00011111'10011111'11111001'11111000,
+    0b00011100'00011110'01111000'00111000,
+    0b00000000'00011100'00111000'00000000,
   };
 
-  Clock const _clock_digital
-  {
-    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-  //      H   sp        h         :         M   sp        m   nl
-  };
+  // digital clock layout
+  //   H sp h : M sp m : S sp s
+  // each digit is 3 blocks wide, spaces are 1 block and colons are 3 blocks
+  static std::size_t constexpr _digital_col[] {0, 4, 10, 14, 20, 24};
+  static std::size_t constexpr _digital_colon[] {8, 18};
 
-  Clock const _clock_digital_seconds
-  {
-    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
-  //      H   sp        h         :         M   sp        m         :         S   sp        s   nl
-  };
+  // binary clock layout
+  //   H h M m S s
+  // blocks above the highest bit a digit can use are empty
+  static std::size_t constexpr _binary_bits[] {2, 4, 3, 4, 3, 4};
 
-  Clock const _clock_binary
+  // size of a clock template in blocks
+  template<Mode::Type mode, bool seconds>
+  struct Shape
   {
-    -1, 0, -1, 0,  2,
-    -1, 0,  0, 0,  2,
-     0, 0,  0, 0,  2,
-     0, 0,  0, 0,  2,
-  // H  h   M  m   nl
+    static std::size_t constexpr x {
+      mode == Mode::icon ? 32 :
+      mode == Mode::binary ? (seconds ? 6 : 4) :
+      mode == Mode::digital ? (seconds ? 27 : 17) : 0};
+
+    static std::size_t constexpr y {
+      mode == Mode::icon ? 18 :
+      mode == Mode::binary ? 4 :
+      mode == Mode::digital ? 5 : 0};
   };
 
-  Clock const _clock_binary_seconds
-  {
-    -1, 0, -1, 0, -1, 0,  2,
-    -1, 0,  0, 0,  0, 0,  2,
-     0, 0,  0, 0,  0, 0,  2,
-     0, 0,  0, 0,  0, 0,  2,
-  // H  h   M  m   S  s   nl
-  };
+  // large enough to hold any clock template
+  using Clock = std::array<int, Shape<Mode::icon, false>::x * Shape<Mode::icon, false>::y>;
 
   struct Ctx
   {
-    Clock value
+    std::array<int, 6> value
     {
        0, 0, 0, 0, 0, 0
     // H  h  M  m  S  s
     };
 
-    Clock buffer;
-
     Rect background;
     Rect title;
     Rect block;
@@ -447,6 +485,41 @@ private:
     std::size_t x {0};
     std::size_t y {0};
 
+    // pre-rendered rows for blocks filled with a string
+    struct Fill
+    {
+      // block width, fill string, and colours the row was rendered with
+      std::size_t width {0};
+      std::string str;
+      OB::Grid::style_type fg {0};
+      OB::Grid::style_type bg {0};
+
+      // column offset of the first cell within the block
+      std::size_t offset {0};
+      std::vector<OB::Grid::Cell> cells;
+    };
+
+    Fill fill_active;
+    Fill fill_inactive;
+    Fill fill_colon;
+  } _ctx;
+
+  // start of the colour animation clock
+  std::chrono::steady_clock::time_point const _epoch {std::chrono::steady_clock::now()};
+
+  // time the colours have animated for, instead of the time since _epoch
+  std::optional<std::chrono::milliseconds> _animation_time;
+
+  // geometry derived from the terminal size and cfg,
+  // only recalculated when one of them changes
+  struct Layout
+  {
+    // terminal size and cfg generation the layout was calculated for
+    std::size_t generation {std::numeric_limits<std::size_t>::max()};
+
+    // block types, row major with a row length of x_blocks
+    Clock buffer {};
+
     std::size_t width {0};
     std::size_t height {0};
 
@@ -461,34 +534,58 @@ private:
 
     std::size_t x_begin {0};
     std::size_t y_begin {0};
-  } _ctx;
+  } _layout;
+
+  // incremented on every cfg change
+  std::size_t _generation {0};
+
+  Reduce::Type _reduce {Reduce::none};
 
-  std::size_t const npos {std::numeric_limits<std::size_t>::max()};
+  // cfg.seconds unless the seconds blocks are reduced
+  bool seconds() const;
+
+  // party and candy colours step on each block unless animation is reduced
+  bool stepped(OB::Color const& color) const;
 
-  std::size_t find(Clock const& vec, int const val, std::size_t const pos = 0) const;
-  std::size_t count(Clock const& vec, int const val) const;
-  std::size_t count_x_blocks(Clock const& clock) const;
-  std::size_t count_y_blocks(Clock const& clock) const;
   void extract_digits(int const num, int& t0, int& t1) const;
 
-  void init_ctx(std::size_t const width, std::size_t const height);
+  void init_ctx(std::size_t const width, std::size_t const height, std::time_t const time);
+  void init_layout(std::size_t const width, std::size_t const height);
 
   void calc_xy_block();
   void calc_xy_ratio();
   void calc_xy_begin();
 
-  void fill_digital(std::size_t width, std::size_t begin, std::size_t end, Position::Type type);
-  void fill_binary(std::size_t width, std::size_t col, int num);
+  // write the static blocks of a clock template into the layout buffer
+  template<Mode::Type mode, bool seconds>
+  void raster_init();
+
+  // write the current clock value into the layout buffer
+  template<Mode::Type mode, bool seconds>
+  void raster_value();
 
-  void set_clock_value();
+  void set_clock_value(std::time_t const time);
   void set_date(std::tm const& time_now);
-  void set_clock_digital();
-  void set_clock_binary();
+  void set_clock();
+
+  void draw_background(OB::Grid& grid);
+  void draw_title(OB::Grid& grid);
+  // fill, colours, and whether the background is constant for a block type,
+  // party and candy backgrounds are stepped on each call
+  struct Block
+  {
+    Ctx::Fill& fill;
+    std::string const& str;
+    OB::Color const& fg;
+    OB::Color const& bg;
+    bool solid;
+  };
 
-  void draw_background(std::size_t const width, std::size_t const height, std::ostringstream& buf);
-  void draw_title(std::ostringstream& buf);
-  void draw_clock(std::ostringstream& buf);
-  void draw_date(std::ostringstream& buf);
+  Block block(int type);
+  void draw_clock(OB::Grid& grid);
+  void draw_block(OB::Grid& grid, Ctx::Fill& fill, std::string const& str,
+    OB::Color const& fg, OB::Color const& bg);
+  void draw_date(OB::Grid& grid);
 };
 
 #endif // PEACLOCK_HH
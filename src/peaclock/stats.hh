@@ -0,0 +1,188 @@
+#ifndef STATS_HH
+#define STATS_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
+
+// per-frame timings and counters of the event loop,
+// the most recent frames are kept in a fixed-size ring buffer
+class Stats
+{
+public:
+
+  using clock = std::chrono::steady_clock;
+
+  struct Frame
+  {
+    // when the frame started
+    clock::time_point time {};
+
+    // time spent in each stage of the frame
+    clock::duration layout {0};
+    clock::duration render {0};
+    clock::duration write {0};
+    clock::duration poll {0};
+
+    // bytes written to the terminal
+    std::size_t bytes {0};
+
+    // syscalls made by the event loop, counted at each call site
+    std::size_t syscalls {0};
+
+    // times the event loop woke up from sleeping
+    std::size_t wakeups {0};
+  };
+
+  struct Summary
+  {
+    // number of frames summarised
+    std::size_t frames {0};
+
+    // average microseconds per frame
+    double layout {0};
+    double render {0};
+    double write {0};
+    double poll {0};
+
+    // average bytes per frame
+    double bytes {0};
+
+    // rates over the time covered by the frames
+    double bytes_sec {0};
+    double syscalls_sec {0};
+    double wakeups_sec {0};
+  };
+
+  // start a new frame, overwriting the oldest one when full
+  Frame& next()
+  {
+    _idx = (_idx + 1) % _frames.size();
+
+    if (_size < _frames.size())
+    {
+      ++_size;
+    }
+
+    _frames[_idx] = Frame();
+    _frames[_idx].time = clock::now();
+
+    return _frames[_idx];
+  }
+
+  // the current frame
+  Frame& frame()
+  {
+    return _frames[_idx];
+  }
+
+  // summarise the completed frames, excluding the current one
+  Summary summary() const
+  {
+    Summary res;
+
+    if (_size < 2)
+    {
+      return res;
+    }
+
+    auto const us = [](clock::duration const val) {
+      return std::chrono::duration<double, std::micro>(val).count();
+    };
+
+    double syscalls {0};
+    double wakeups {0};
+
+    // the oldest frame is the one after the current in the ring
+    auto const oldest = _size < _frames.size() ? 0 : (_idx + 1) % _frames.size();
+
+    for (std::size_t i = oldest; i != _idx; i = (i + 1) % _frames.size())
+    {
+      auto const& e = _frames[i];
+
+      res.layout += us(e.layout);
+      res.render += us(e.render);
+      res.write += us(e.write);
+      res.poll += us(e.poll);
+      res.bytes += static_cast<double>(e.bytes);
+      syscalls += static_cast<double>(e.syscalls);
+      wakeups += static_cast<double>(e.wakeups);
+    }
+
+    // the completed frames end where the current one begins
+    auto const sec = std::chrono::duration<double>(
+      _frames[_idx].time - _frames[oldest].time).count();
+
+    if (sec > 0)
+    {
+      res.bytes_sec = res.bytes / sec;
+      res.syscalls_sec = syscalls / sec;
+      res.wakeups_sec = wakeups / sec;
+    }
+
+    res.frames = _size - 1;
+
+    auto const size = static_cast<double>(res.frames);
+
+    res.layout /= size;
+    res.render /= size;
+    res.write /= size;
+    res.poll /= size;
+    res.bytes /= size;
+
+    return res;
+  }
+
+  // full description for the status line
+  std::string str() const
+  {
+    auto const val = summary();
+
+    std::ostringstream os;
+    os
+    << std::fixed << std::setprecision(0)
+    << "stats " << val.frames << " frames"
+    << ", layout " << val.layout << "us"
+    << ", render " << val.render << "us"
+    << ", write " << val.write << "us"
+    << ", poll " << val.poll << "us"
+    << ", " << val.bytes << " B/frame"
+    << ", " << val.bytes_sec << " B/s"
+    << ", " << val.syscalls_sec << " syscalls/s"
+    << ", " << val.wakeups_sec << " wakeups/s";
+
+    return os.str();
+  }
+
+  // compact description for the corner overlay
+  std::string str_short() const
+  {
+    auto const val = summary();
+
+    std::ostringstream os;
+    os
+    << std::fixed << std::setprecision(0)
+    << " " << (val.layout + val.render + val.write) << "us"
+    << " " << val.bytes_sec << "B/s"
+    << " " << val.syscalls_sec << "sys/s"
+    << " " << val.wakeups_sec << "wake/s ";
+
+    return os.str();
+  }
+
+  // draw the overlay in the top right corner
+  bool overlay {false};
+
+private:
+
+  std::array<Frame, 64> _frames {};
+  std::size_t _idx {_frames.size() - 1};
+  std::size_t _size {0};
+}; // class Stats
+
+#endif // STATS_HH
@@ -0,0 +1,226 @@
+#ifndef THROTTLE_HH
+#define THROTTLE_HH
+
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+
+// keeps the output within what the terminal drains and within an optional
+// budget, by choosing how far the output is reduced,
+// levels go from 0, nothing reduced, up to one less than the number of levels
+class Throttle
+{
+public:
+
+  using clock = std::chrono::steady_clock;
+
+  explicit Throttle(std::size_t const levels) :
+    _levels {std::min(levels, _cost.size())}
+  {
+  }
+
+  // bytes per second the output may use, 0 for no budget
+  void budget(std::size_t const val)
+  {
+    _budget = val;
+  }
+
+  // called before a frame is output, with the bytes still queued in the
+  // terminal, returns true when the frame should be skipped so that it
+  // doesn't wait behind older output
+  bool blocked(std::size_t const queued, clock::time_point const now)
+  {
+    // the queue kept draining since the last write, which measures the link
+    if (queued > 0 && queued < _queued)
+    {
+      measure(static_cast<double>(_queued - queued) / seconds(now - _queued_time), now);
+    }
+
+    window(now);
+
+    if (queued == 0)
+    {
+      return false;
+    }
+
+    // try again once the queue should have drained,
+    // the frame is held back until then
+    auto const lim = limit(now);
+    auto const wait = lim > 0 ? std::chrono::duration<double>(static_cast<double>(queued) / lim) :
+      std::chrono::duration<double>(_wait_min);
+    _wait = std::clamp(std::chrono::duration_cast<clock::duration>(wait), _wait_min, _wait_max);
+    _busy += _wait;
+
+    return true;
+  }
+
+  // called after a frame is output, with the bytes written, how long the
+  // write took, and the bytes still queued in the terminal after it
+  void wrote(std::size_t const bytes, clock::duration const took, std::size_t const queued,
+    clock::time_point const now)
+  {
+    // a write that blocked waited for the terminal to drain the bytes
+    if (bytes > 0 && took > _blocked)
+    {
+      measure(static_cast<double>(bytes) / seconds(took), now);
+      _busy += took;
+    }
+
+    _queued = queued;
+    _queued_time = now;
+    _bytes += bytes;
+
+    window(now);
+  }
+
+  // how long to wait before trying a skipped frame again
+  clock::duration wait() const
+  {
+    return _wait;
+  }
+
+  // current level of reduction
+  std::size_t level() const
+  {
+    return _level;
+  }
+
+  // bytes per second the terminal was measured to drain, 0 when it kept up
+  double drain() const
+  {
+    return _drain;
+  }
+
+  // bytes per second output over the last window
+  double rate() const
+  {
+    return _rate;
+  }
+
+private:
+
+  static double seconds(clock::duration const val)
+  {
+    return std::max(std::chrono::duration<double>(val).count(), 1e-6);
+  }
+
+  void measure(double const val, clock::time_point const now)
+  {
+    _drain = val;
+    _drain_time = now;
+  }
+
+  // bytes per second the output has to stay within, 0 for no limit
+  double limit(clock::time_point const now)
+  {
+    // a measurement is dropped once the terminal has kept up for a while,
+    // so a link that got faster is used again
+    if (_drain > 0 && now - _drain_time > _drain_max)
+    {
+      _drain = 0;
+    }
+
+    auto res = _budget > 0 ? static_cast<double>(_budget) : std::numeric_limits<double>::max();
+
+    if (_drain > 0)
+    {
+      res = std::min(res, _drain);
+    }
+
+    return res == std::numeric_limits<double>::max() ? 0 : res;
+  }
+
+  // at the end of each window, reduce the output when it was over the budget,
+  // or when frames spent most of it waiting for the terminal, which is the
+  // output needing more than the terminal drains, even while older output
+  // is still queued, or restore the output when what it needed before fits
+  void window(clock::time_point const now)
+  {
+    auto const span = now - _window_time;
+
+    if (span < _window)
+    {
+      return;
+    }
+
+    _rate = static_cast<double>(_bytes) / seconds(span);
+    auto const busy = seconds(std::min(_busy, span)) / seconds(span);
+    _bytes = 0;
+    _busy = {};
+    _window_time = now;
+
+    auto const lim = limit(now);
+
+    if ((_budget > 0 && _rate > static_cast<double>(_budget)) || busy > 0.5)
+    {
+      reduce(now, std::max(_rate, lim));
+    }
+    else if (_level > 0 && now - _changed > _restore &&
+      (lim == 0 || _cost[_level - 1] < lim * 0.8))
+    {
+      --_level;
+      _changed = now;
+      _restored = true;
+    }
+  }
+
+  // cost is the output rate the current level needed
+  void reduce(clock::time_point const now, double const cost)
+  {
+    // give the last change a window to take effect
+    if (_level + 1 >= _levels || now - _changed < _window)
+    {
+      return;
+    }
+
+    // a restore that didn't fit is tried again less often
+    if (_restored && now - _changed < _restore)
+    {
+      _restore = std::min(_restore * 2, _restore_max);
+    }
+
+    _cost[_level] = cost;
+    ++_level;
+    _changed = now;
+    _restored = false;
+  }
+
+  static constexpr clock::duration _window {std::chrono::seconds(1)};
+  static constexpr clock::duration _restore_max {std::chrono::minutes(10)};
+  static constexpr clock::duration _drain_max {std::chrono::seconds(30)};
+  static constexpr clock::duration _blocked {std::chrono::milliseconds(2)};
+  static constexpr clock::duration _wait_min {std::chrono::milliseconds(10)};
+  static constexpr clock::duration _wait_max {std::chrono::seconds(1)};
+
+  // output rate measured at each level before it was reduced past it
+  std::array<double, 8> _cost {};
+  std::size_t const _levels;
+  std::size_t _level {0};
+  clock::time_point _changed {};
+
+  // time a level is kept before trying the one before it, and whether
+  // the last change was such a try
+  clock::duration _restore {std::chrono::seconds(10)};
+  bool _restored {false};
+
+  std::size_t _budget {0};
+
+  double _drain {0};
+  clock::time_point _drain_time {};
+
+  std::size_t _queued {0};
+  clock::time_point _queued_time {};
+
+  // output and time spent waiting on the terminal in the current window
+  std::size_t _bytes {0};
+  clock::duration _busy {};
+  double _rate {0};
+  clock::time_point _window_time {clock::now()};
+
+  clock::duration _wait {_wait_min};
+}; // class Throttle
+
+#endif // THROTTLE_HH
@@ -7,6 +7,10 @@
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
 #include <ctime>
 #include <cmath>
 #include <cctype>
@@ -14,8 +18,13 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -24,10 +33,16 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <chrono>
 #include <thread>
 #include <algorithm>
-#include <regex>
 #include <utility>
 #include <optional>
 #include <limits>
+#include <tuple>
+#include <type_traits>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <initializer_list>
 
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -37,10 +52,432 @@ using std::string_literals::operator""s;
 // bool to string
 #define btos(x) ("off\0on"+4*!!(x))
 
+namespace
+{
+
+// argument parsers for Tui::command, each one has to consume the whole string
+
+bool is_space(char const c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+// split off the first word and the whitespace that follows it
+std::pair<std::string_view, std::string_view> parse_word(std::string_view const str)
+{
+  std::size_t i {0};
+
+  while (i < str.size() && ! is_space(str[i]))
+  {
+    ++i;
+  }
+
+  auto const word = str.substr(0, i);
+
+  while (i < str.size() && is_space(str[i]))
+  {
+    ++i;
+  }
+
+  return {word, str.substr(i)};
+}
+
+// unsigned integer, saturated at the int maximum
+std::optional<int> parse_int(std::string_view const str)
+{
+  if (str.empty())
+  {
+    return {};
+  }
+
+  int res {0};
+
+  for (auto const c : str)
+  {
+    if (c < '0' || c > '9')
+    {
+      return {};
+    }
+
+    if (res > (std::numeric_limits<int>::max() - (c - '0')) / 10)
+    {
+      res = std::numeric_limits<int>::max();
+    }
+    else
+    {
+      res = (res * 10) + (c - '0');
+    }
+  }
+
+  return res;
+}
+
+// two unsigned integers separated by whitespace
+std::optional<std::pair<int, int>> parse_int_pair(std::string_view const str)
+{
+  auto const [lhs, rhs] = parse_word(str);
+  auto const x = parse_int(lhs);
+  auto const y = parse_int(rhs);
+
+  if (! x || ! y)
+  {
+    return {};
+  }
+
+  return std::make_pair(x.value(), y.value());
+}
+
+std::optional<bool> parse_bool(std::string_view const str)
+{
+  if (str == "true" || str == "t" || str == "1" || str == "on")
+  {
+    return true;
+  }
+
+  if (str == "false" || str == "f" || str == "0" || str == "off")
+  {
+    return false;
+  }
+
+  return {};
+}
+
+// index of the matching value
+std::optional<std::size_t> parse_enum(std::string_view const str,
+  std::initializer_list<std::string_view> const values)
+{
+  std::size_t idx {0};
+
+  for (auto const& e : values)
+  {
+    if (str == e)
+    {
+      return idx;
+    }
+
+    ++idx;
+  }
+
+  return {};
+}
+
+// single or double quoted string with backslash escapes,
+// returns the contents between the quotes
+std::optional<std::string_view> parse_str(std::string_view const str)
+{
+  if (str.size() < 2 || (str.front() != '\'' && str.front() != '"'))
+  {
+    return {};
+  }
+
+  for (std::size_t i = 1; i < str.size(); ++i)
+  {
+    if (str[i] == '\\')
+    {
+      ++i;
+    }
+    else if (str[i] == str.front())
+    {
+      if (i + 1 != str.size())
+      {
+        return {};
+      }
+
+      return str.substr(1, str.size() - 2);
+    }
+  }
+
+  return {};
+}
+
+std::pair<bool, std::string> unknown(std::string const& input)
+{
+  return std::make_pair(false, "warning: unknown command '" + input + "'");
+}
+
+// the commands of a config file with their line numbers,
+// trimmed and without empty lines or comments
+std::vector<std::pair<std::size_t, std::string>> config_lines(std::string const& contents)
+{
+  std::vector<std::pair<std::size_t, std::string>> res;
+
+  std::istringstream is {contents};
+  std::string line;
+  std::size_t lnum {0};
+
+  while (std::getline(is, line))
+  {
+    ++lnum;
+
+    line = OB::String::trim(line);
+
+    if (line.empty() || (line.front() == '#' && line.find('\r') == std::string::npos))
+    {
+      continue;
+    }
+
+    res.emplace_back(lnum, std::move(line));
+  }
+
+  return res;
+}
+
+// commands that set overlapping values share a group, such as 'block' and
+// 'block-x', the style and set commands are grouped by the value they set
+std::string config_group(std::string_view const line)
+{
+  auto const [name, args] = parse_word(line);
+
+  if (name == "style" || name == "set")
+  {
+    return std::string(name) + " " + std::string(parse_word(args).first);
+  }
+
+  return std::string(name.substr(0, name.find('-')));
+}
+
+std::unordered_map<std::string, std::vector<std::string>> config_groups(
+  std::vector<std::pair<std::size_t, std::string>> const& lines)
+{
+  std::unordered_map<std::string, std::vector<std::string>> res;
+
+  for (auto const& [lnum, line] : lines)
+  {
+    res[config_group(line)].emplace_back(line);
+  }
+
+  return res;
+}
+
+// read a whole file with a single read
+std::optional<std::string> read_file(fs::path const& path)
+{
+  std::ifstream file {path, std::ios::binary | std::ios::ate};
+
+  if (! file.is_open())
+  {
+    return {};
+  }
+
+  std::string res;
+  res.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+
+  if (! file.read(res.data(), static_cast<std::streamsize>(res.size())))
+  {
+    return {};
+  }
+
+  return res;
+}
+
+// written at the start of the config cache, bump the version whenever the
+// stored settings change
+constexpr std::string_view cache_magic {"peaclock-config"};
+constexpr std::uint64_t cache_version {2};
+
+// 64-bit fnv-1a
+std::uint64_t hash(std::string_view const str)
+{
+  std::uint64_t res {0xcbf29ce484222325};
+
+  for (auto const c : str)
+  {
+    res ^= static_cast<unsigned char>(c);
+    res *= 0x100000001b3;
+  }
+
+  return res;
+}
+
+// encodes settings into the config cache, integers are stored in native
+// byte order as the cache is only read back on the same machine
+class Cache_Writer
+{
+public:
+
+  void num(std::uint64_t const val)
+  {
+    _buf.append(reinterpret_cast<char const*>(&val), sizeof(val));
+  }
+
+  void str(std::string_view const val)
+  {
+    num(val.size());
+    _buf.append(val);
+  }
+
+  template<typename T>
+  void operator()(OB::basic_num<T>& val)
+  {
+    num(static_cast<std::uint64_t>(val.get()));
+  }
+
+  template<typename T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, int> = 0>
+  void operator()(T& val)
+  {
+    num(static_cast<std::uint64_t>(val));
+  }
+
+  void operator()(std::string& val)
+  {
+    str(val);
+  }
+
+  void operator()(OB::Color& val)
+  {
+    str(val.key());
+  }
+
+  std::string const& buf() const
+  {
+    return _buf;
+  }
+
+private:
+
+  std::string _buf;
+};
+
+// decodes settings from the config cache, any read past the end or invalid
+// value marks the whole cache as invalid
+class Cache_Reader
+{
+public:
+
+  explicit Cache_Reader(std::string_view const buf) :
+    _buf {buf}
+  {
+  }
+
+  std::uint64_t num()
+  {
+    std::uint64_t res {0};
+
+    if (_buf.size() - _pos < sizeof(res))
+    {
+      _valid = false;
+
+      return res;
+    }
+
+    std::memcpy(&res, _buf.data() + _pos, sizeof(res));
+    _pos += sizeof(res);
+
+    return res;
+  }
+
+  std::string_view str()
+  {
+    auto const size = num();
+
+    if (_buf.size() - _pos < size)
+    {
+      _valid = false;
+
+      return {};
+    }
+
+    auto const res = _buf.substr(_pos, size);
+    _pos += size;
+
+    return res;
+  }
+
+  template<typename T>
+  void operator()(OB::basic_num<T>& val)
+  {
+    val = static_cast<T>(num());
+  }
+
+  template<typename T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, int> = 0>
+  void operator()(T& val)
+  {
+    val = static_cast<T>(num());
+  }
+
+  void operator()(std::string& val)
+  {
+    val = str();
+  }
+
+  void operator()(OB::Color& val)
+  {
+    auto const key = str();
+    OB::Color res {std::string(key), val.is_fg() ? OB::Color::Type::fg : OB::Color::Type::bg};
+
+    // colours that were never set have an empty key
+    if (! res && ! key.empty())
+    {
+      _valid = false;
+    }
+
+    val = res;
+  }
+
+  // every read succeeded and the whole buffer was consumed
+  bool valid() const
+  {
+    return _valid && _pos == _buf.size();
+  }
+
+private:
+
+  std::string_view _buf;
+  std::size_t _pos {0};
+  bool _valid {true};
+};
+
+// bytes written to the terminal that it hasn't sent yet, 0 when unknown
+std::size_t output_queued()
+{
+  int size {0};
+
+  if (ioctl(STDOUT_FILENO, TIOCOUTQ, &size) == -1 || size < 0)
+  {
+    return 0;
+  }
+
+  return static_cast<std::size_t>(size);
+}
+
+} // namespace
+
 Tui::Tui() :
   _colorterm {OB::Term::is_colorterm()}
 {
-  _ctx.prompt.timeout = _ctx.prompt.rate.get() / _ctx.refresh_rate.get();
+  _ctx.grid.depth(colour_depth());
+}
+
+OB::Color::Depth::Type Tui::colour_depth() const
+{
+  if (_ctx.colour_depth)
+  {
+    return static_cast<OB::Color::Depth::Type>(_ctx.colour_depth);
+  }
+
+  if (_colorterm)
+  {
+    return OB::Color::Depth::bit24;
+  }
+
+  if (auto const term = std::getenv("TERM"); term &&
+    std::string_view(term).find("256color") != std::string_view::npos)
+  {
+    return OB::Color::Depth::bit8;
+  }
+
+  return OB::Color::Depth::bit4;
+}
+
+OB::Term::Mode& Tui::term_mode()
+{
+  if (! _term_mode)
+  {
+    _term_mode.emplace();
+  }
+
+  return *_term_mode;
 }
 
 bool Tui::press_to_continue(std::string const& str, char32_t val)
@@ -48,8 +485,8 @@ bool Tui::press_to_continue(std::string const& str, char32_t val)
   std::cerr
   << "Press " << str << " to continue";
 
-  _term_mode.set_min(1);
-  _term_mode.set_raw();
+  term_mode().set_min(1);
+  term_mode().set_raw();
 
   bool res {false};
   char32_t key {0};
@@ -58,7 +495,7 @@ bool Tui::press_to_continue(std::string const& str, char32_t val)
     res = (val == 0 ? true : val == key);
   }
 
-  _term_mode.set_cooked();
+  term_mode().set_cooked();
 
   std::cerr
   << aec::nl;
@@ -84,27 +521,33 @@ void Tui::load_config(fs::path const& path)
 
   if (! path.empty() && fs::exists(path))
   {
-    std::ifstream file {path};
-
-    if (file.is_open())
+    if (auto file = read_file(path))
     {
-      std::string line;
-      std::size_t lnum {0};
+      auto& contents = file.value();
 
-      while (std::getline(file, line))
-      {
-        // increase line number
-        ++lnum;
+      // remembered to find what changed when the file is reloaded
+      _ctx.config_path = path;
+
+      Config_Key key;
 
-        // trim leading and trailing whitespace
-        line = OB::String::trim(line);
+      if (_ctx.config_cache)
+      {
+        key = config_key(path, contents);
 
-        // ignore empty line or comment
-        if (line.empty() || OB::String::assert_rx(line, std::regex("^#[^\\r]*$")))
+        if (load_config_cache(path, key))
         {
-          continue;
+          _ctx.config_contents = std::move(contents);
+
+          return;
         }
+      }
 
+      auto const lines = config_lines(contents);
+      _ctx.config_groups = config_groups(lines);
+      _ctx.config_contents.reset();
+
+      for (auto const& [lnum, line] : lines)
+      {
         if (auto const res = command(line))
         {
           if (! res.value().first)
@@ -114,6 +557,12 @@ void Tui::load_config(fs::path const& path)
           }
         }
       }
+
+      // only a config that applied cleanly is cached
+      if (_ctx.config_cache && err.str().empty() && _ctx.is_running)
+      {
+        save_config_cache(path, key);
+      }
     }
     else
     {
@@ -129,6 +578,11 @@ void Tui::load_config(fs::path const& path)
   {
     std::cerr << err.str();
 
+    if (_ctx.headless)
+    {
+      throw std::runtime_error("invalid config file '" + path.string() + "'");
+    }
+
     if (! press_to_continue("ENTER", '\n'))
     {
       throw std::runtime_error("aborted by user");
@@ -136,6 +590,263 @@ void Tui::load_config(fs::path const& path)
   }
 }
 
+template<typename T>
+void Tui::config_fields(T& io)
+{
+  auto& cfg = _peaclock.cfg;
+
+  io(_ctx.input_interval);
+  io(_ctx.refresh_rate);
+  io(_ctx.output.rate);
+  io(_ctx.prompt.rate);
+  io(_ctx.colour_depth);
+
+  io(_ctx.style.text);
+  io(_ctx.style.prompt);
+  io(_ctx.style.success);
+  io(_ctx.style.error);
+  io(_ctx.style.background);
+
+  io(cfg.mode);
+  io(cfg.toggle);
+
+  io(cfg.hour_24);
+  io(cfg.seconds);
+  io(cfg.date);
+  io(cfg.auto_size);
+  io(cfg.auto_ratio);
+
+  io(cfg.x_block);
+  io(cfg.y_block);
+  io(cfg.x_ratio);
+  io(cfg.y_ratio);
+  io(cfg.x_border);
+  io(cfg.y_border);
+  io(cfg.x_space);
+  io(cfg.y_space);
+  io(cfg.rate_animation);
+
+  io(cfg.locale);
+  io(cfg.timezone);
+  io(cfg.datefmt);
+  io(cfg.fill_active);
+  io(cfg.fill_inactive);
+  io(cfg.fill_colon);
+
+  io(cfg.style.active_fg);
+  io(cfg.style.inactive_fg);
+  io(cfg.style.active_bg);
+  io(cfg.style.inactive_bg);
+  io(cfg.style.colon_fg);
+  io(cfg.style.colon_bg);
+  io(cfg.style.date);
+  io(cfg.style.background);
+}
+
+Tui::Config_Key Tui::config_key(fs::path const& path, std::string const& contents)
+{
+  Config_Key res;
+
+  std::error_code ec;
+  res.mtime = static_cast<std::int64_t>(
+    fs::last_write_time(path, ec).time_since_epoch().count());
+  res.size = contents.size();
+  res.hash = hash(contents);
+
+  return res;
+}
+
+std::string Tui::config_snapshot()
+{
+  Cache_Writer out;
+
+  std::uint64_t stats {_ctx.stats ? (_ctx.stats->overlay ? 2ul : 1ul) : 0ul};
+  config_fields(out);
+  out(stats);
+
+  return out.buf();
+}
+
+bool Tui::config_restore(std::string_view const buf)
+{
+  // decode into a copy so an invalid snapshot leaves the settings untouched
+  auto const ctx_prev = std::make_tuple(_ctx.input_interval, _ctx.refresh_rate,
+    _ctx.output.rate, _ctx.prompt.rate, _ctx.colour_depth, _ctx.style);
+  auto const cfg_prev = _peaclock.cfg;
+
+  Cache_Reader in {buf};
+  std::uint64_t stats {0};
+  config_fields(in);
+  in(stats);
+
+  // only the values the commands accept
+  auto const depth = _ctx.colour_depth;
+  bool const depth_valid {depth == 0 || depth == 4 || depth == 8 || depth == 24};
+
+  if (! in.valid() || stats > 2 || ! depth_valid)
+  {
+    std::tie(_ctx.input_interval, _ctx.refresh_rate, _ctx.output.rate,
+      _ctx.prompt.rate, _ctx.colour_depth, _ctx.style) = ctx_prev;
+    _peaclock.cfg = cfg_prev;
+
+    return false;
+  }
+
+  // settings derived from the stored values
+  _ctx.grid.depth(colour_depth());
+  _peaclock.cfg_datefmt(_peaclock.cfg.datefmt);
+  _peaclock.cfg_timezone(_peaclock.cfg.timezone);
+
+  if (! stats)
+  {
+    _ctx.stats.reset();
+  }
+  else
+  {
+    if (! _ctx.stats)
+    {
+      _ctx.stats.emplace();
+    }
+
+    _ctx.stats->overlay = stats == 2;
+  }
+
+  _peaclock.cfg_changed();
+
+  return true;
+}
+
+bool Tui::load_config_cache(fs::path const& path, Config_Key const& key)
+{
+  auto const buf = read_file(path.string() + ".cache");
+  auto const header = cache_magic.size() + (4 * sizeof(std::uint64_t));
+
+  if (! buf || buf.value().size() < header ||
+    buf.value().compare(0, cache_magic.size(), cache_magic) != 0)
+  {
+    return false;
+  }
+
+  Cache_Reader in {std::string_view(buf.value()).substr(cache_magic.size(), header - cache_magic.size())};
+
+  if (in.num() != cache_version ||
+    static_cast<std::int64_t>(in.num()) != key.mtime ||
+    in.num() != key.size || in.num() != key.hash)
+  {
+    return false;
+  }
+
+  return config_restore(std::string_view(buf.value()).substr(header));
+}
+
+void Tui::save_config_cache(fs::path const& path, Config_Key const& key)
+{
+  Cache_Writer out;
+  out.num(cache_version);
+  out.num(static_cast<std::uint64_t>(key.mtime));
+  out.num(key.size);
+  out.num(key.hash);
+
+  // write to a temporary file and rename it so a reader never sees a partial cache,
+  // failing to write the cache is not an error
+  auto const cache = path.string() + ".cache";
+  auto const tmp = cache + ".tmp";
+
+  {
+    std::ofstream file {tmp, std::ios::binary | std::ios::trunc};
+
+    if (! file.is_open())
+    {
+      return;
+    }
+
+    file << cache_magic << out.buf() << config_snapshot();
+
+    if (! file)
+    {
+      return;
+    }
+  }
+
+  std::error_code ec;
+  fs::rename(tmp, cache, ec);
+
+  if (ec)
+  {
+    fs::remove(tmp, ec);
+  }
+}
+
+bool Tui::reload_config()
+{
+  // the file may briefly not exist while it is being replaced
+  auto const file = read_file(_ctx.config_path);
+
+  if (! file)
+  {
+    return false;
+  }
+
+  // the config was loaded from the cache, find its groups to compare against
+  if (_ctx.config_contents)
+  {
+    _ctx.config_groups = config_groups(config_lines(_ctx.config_contents.value()));
+    _ctx.config_contents.reset();
+  }
+
+  auto const lines = config_lines(file.value());
+  auto groups = config_groups(lines);
+
+  // groups whose lines were added or changed,
+  // settings whose lines were removed keep their current value
+  std::unordered_set<std::string> dirty;
+
+  for (auto const& [key, val] : groups)
+  {
+    if (auto const it = _ctx.config_groups.find(key);
+      it == _ctx.config_groups.end() || it->second != val)
+    {
+      dirty.emplace(key);
+    }
+  }
+
+  if (dirty.empty())
+  {
+    return false;
+  }
+
+  // apply the changed groups in file order, or nothing at all
+  auto const prev = config_snapshot();
+
+  for (auto const& [lnum, line] : lines)
+  {
+    if (! dirty.count(config_group(line)))
+    {
+      continue;
+    }
+
+    if (auto const res = command(line); res && ! res.value().first)
+    {
+      config_restore(prev);
+      set_status(false, "config not reloaded, " + _ctx.config_path.string() + ":" +
+        std::to_string(lnum) + ": " + res.value().second);
+
+      return true;
+    }
+  }
+
+  _ctx.config_groups = std::move(groups);
+
+  if (_ctx.config_cache)
+  {
+    save_config_cache(_ctx.config_path, config_key(_ctx.config_path, file.value()));
+  }
+
+  set_status(true, "config reloaded");
+
+  return true;
+}
+
 void Tui::load_hist_command(fs::path const& path)
 {
   _readline.hist_load(path);
@@ -179,6 +890,11 @@ void Tui::load_hist_command(fs::path const& path)
 
 void Tui::run()
 {
+  if (! _ctx.timer.open())
+  {
+    throw std::runtime_error("timerfd failed");
+  }
+
   std::cout
   << aec::cursor_hide
   << aec::screen_push
@@ -188,116 +904,382 @@ void Tui::run()
   << aec::mouse_enable
   << std::flush;
 
-  // set terminal mode to raw
-  _term_mode.set_min(0);
-  _term_mode.set_raw();
+  // set terminal mode to raw
+  term_mode().set_min(0);
+  term_mode().set_raw();
+
+  // only wrap frames in synchronized output when the terminal reports
+  // the mode can be switched, others would be sent bytes they ignore
+  auto const sync = OB::Term::mode_report(2026, std::chrono::milliseconds(500));
+  _ctx.sync = sync == 1 || sync == 2;
+
+  // reload the config when it is edited, without inotify it is only read at startup
+  if (! _ctx.config_path.empty())
+  {
+    _ctx.config_watch.watch(_ctx.config_path);
+  }
+
+  // resize and exit requests, without signalfd they keep their default action
+  _ctx.signal.open({SIGWINCH, SIGTERM, SIGHUP, SIGINT});
+
+  // start the event loop
+  event_loop();
+
+  _ctx.signal.close();
+  _ctx.timer.close();
+
+  std::cout
+  << aec::mouse_disable
+  << aec::nl
+  << aec::screen_pop
+  << aec::cursor_show
+  << std::flush;
+}
+
+void Tui::headless(bool const val)
+{
+  _ctx.headless = val;
+}
+
+void Tui::config_cache(bool const val)
+{
+  _ctx.config_cache = val;
+}
+
+std::string Tui::render_once(std::size_t const width, std::size_t const height,
+  std::time_t const time)
+{
+  if (width < _ctx.width_min || height < _ctx.height_min)
+  {
+    throw std::runtime_error("size must be at least " +
+      std::to_string(_ctx.width_min) + "x" + std::to_string(_ctx.height_min));
+  }
+
+  _ctx.width = width;
+  _ctx.height = height;
+  _ctx.time = wall_clock::now();
+
+  // animated colours take their phase from the fixed time
+  _peaclock.animation_time(std::chrono::seconds(time));
+
+  clear();
+  _peaclock.render(_ctx.width, _ctx.height, _ctx.grid, time);
+  draw_prompt_message();
+  draw_keybuf();
+
+  // output the whole frame
+  _ctx.grid.invalidate();
+  _ctx.grid.flush(_ctx.buf);
+
+  std::string str {_ctx.buf.view()};
+  _ctx.buf.clear();
+
+  return str;
+}
+
+Tui::wall_clock::time_point Tui::next_frame() const
+{
+  auto next = wall_clock::from_time_t(_peaclock.next_change(wall_clock::to_time_t(_ctx.time)));
+
+  // animated colours and the stats overlay change on every frame
+  if (_peaclock.animated() || (_ctx.stats && _ctx.stats->overlay))
+  {
+    next = _ctx.time + std::chrono::milliseconds(_ctx.refresh_rate.get());
+  }
+
+  // remove the prompt message when it expires
+  if (_ctx.prompt.until > _ctx.time)
+  {
+    next = std::min(next, _ctx.prompt.until);
+  }
 
-  // start the event loop
-  event_loop();
+  // output the frame that was skipped once the terminal has caught up
+  if (_ctx.output.retry > _ctx.time)
+  {
+    next = std::min(next, _ctx.output.retry);
+  }
 
-  std::cout
-  << aec::mouse_disable
-  << aec::nl
-  << aec::screen_pop
-  << aec::cursor_show
-  << std::flush;
+  return next;
 }
 
 void Tui::event_loop()
 {
+  // keys, the frame timer, signals, and config file events,
+  // a closed descriptor is -1 and ignored by poll
+  std::array<pollfd, 4> fds {{
+    {STDIN_FILENO, POLLIN, 0},
+    {_ctx.timer.fd(), POLLIN, 0},
+    {_ctx.signal.fd(), POLLIN, 0},
+    {_ctx.config_watch.fd(), POLLIN, 0},
+  }};
+
   while (_ctx.is_running)
   {
-    // get the terminal width and height
-    OB::Term::size(_ctx.width, _ctx.height);
+    if (_ctx.stats)
+    {
+      _ctx.stats->next();
+    }
+
+    // only read the terminal size after a resize, or on every frame
+    // when resizes can't be signalled
+    if (_ctx.resize.pending || _ctx.signal.fd() == -1)
+    {
+      _ctx.resize.pending = false;
+
+      if (_ctx.stats)
+      {
+        // the ioctl for the terminal size
+        ++_ctx.stats->frame().syscalls;
+      }
+
+      auto const width = _ctx.width;
+      auto const height = _ctx.height;
+
+      OB::Term::size(_ctx.width, _ctx.height);
+
+      // the terminal may have reflowed its contents, even at the same size
+      if (_ctx.signal.fd() != -1 || width != _ctx.width || height != _ctx.height)
+      {
+        _ctx.grid.invalidate();
+      }
+    }
 
     // check for correct screen size
-    if (screen_size() != 0)
+    bool const valid {screen_size() == 0};
+    auto next = wall_clock::time_point::max();
+
+    if (valid)
+    {
+      // render new content
+      _ctx.time = wall_clock::now();
+      clear();
+      draw();
+      refresh();
+
+      // wake when the output next changes
+      next = next_frame();
+    }
+
+    // without signalfd a resize is only noticed by reading the size,
+    // so wake at least once per refresh interval to read it,
+    // even while the screen is too small to draw
+    if (_ctx.signal.fd() == -1)
     {
-      std::this_thread::sleep_for(std::chrono::milliseconds(_ctx.input_interval));
+      next = std::min(next, wall_clock::now() + std::chrono::milliseconds(_ctx.refresh_rate.get()));
+    }
+
+    if (next != wall_clock::time_point::max())
+    {
+      _ctx.timer.set(next);
+
+      if (_ctx.stats)
+      {
+        // the timerfd_settime
+        ++_ctx.stats->frame().syscalls;
+      }
+    }
+
+    // block until the frame is due, or an event changes the output
+    bool redraw {false};
+
+    while (_ctx.is_running && ! redraw)
+    {
+      if (poll(fds.data(), fds.size(), -1) == -1)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+
+        throw std::runtime_error("poll failed");
+      }
 
-      char32_t key {0};
-      if ((key = OB::Term::get_key()) > 0)
+      auto const begin = _ctx.stats ? Stats::clock::now() : Stats::clock::time_point();
+      std::size_t syscalls {1};
+
+      if (fds[2].revents & POLLIN)
       {
-        switch (key)
+        while (auto const sig = _ctx.signal.next())
         {
-          case 'q': case 'Q':
-          case OB::Term::ctrl_key('c'):
+          ++syscalls;
+
+          if (sig == SIGWINCH)
           {
-            _ctx.is_running = false;
+            // a drag sends a burst of resizes, redraw once they settle,
+            // but no later than the max after the first one
+            auto const now = wall_clock::now();
 
-            break;
-          }
+            if (! _ctx.resize.pending)
+            {
+              _ctx.resize.pending = true;
+              _ctx.resize.begin = now;
+            }
 
-          default:
+            _ctx.timer.set(std::min(now + _ctx.resize.settle,
+              _ctx.resize.begin + _ctx.resize.max));
+            ++syscalls;
+          }
+          else
           {
-            break;
+            _ctx.is_running = false;
           }
         }
-      }
 
-      continue;
-    }
+        ++syscalls;
+      }
 
-    // render new content
-    clear();
-    draw();
-    refresh();
+      if (fds[1].revents & POLLIN)
+      {
+        ++syscalls;
 
-    int wait {_ctx.refresh_rate.get()};
-    int tick {0};
+        if (_ctx.timer.expired())
+        {
+          redraw = true;
+        }
+      }
 
-    while (_ctx.is_running && wait)
-    {
-      if (wait > _ctx.input_interval.get())
+      if (fds[0].revents & (POLLHUP | POLLERR))
       {
-        tick = _ctx.input_interval.get();
-        wait -= _ctx.input_interval.get();
+        // the terminal went away
+        _ctx.is_running = false;
       }
-      else
+      else if (fds[0].revents & POLLIN)
       {
-        tick = wait;
-        wait = 0;
+        // read every key that arrived, then show their effect straight away
+        if (valid)
+        {
+          do
+          {
+            get_input();
+            ++syscalls;
+          }
+          while (_ctx.is_running && _ctx.key.val > 0);
+        }
+        else
+        {
+          // only quit until the terminal is large enough
+          char32_t key {0};
+
+          while ((key = OB::Term::get_key()) > 0)
+          {
+            ++syscalls;
+
+            if (key == 'q' || key == 'Q' || key == OB::Term::ctrl_key('c'))
+            {
+              _ctx.is_running = false;
+            }
+          }
+
+          ++syscalls;
+        }
+
+        redraw = true;
       }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(tick));
+      if (fds[3].revents & POLLIN)
+      {
+        ++syscalls;
+
+        // redraw straight away to show the new config
+        if (_ctx.config_watch.changed() && reload_config())
+        {
+          redraw = true;
+        }
+      }
 
-      get_input();
+      // the command prompt may have disabled stats
+      if (_ctx.stats)
+      {
+        auto& frame = _ctx.stats->frame();
+        frame.poll += Stats::clock::now() - begin;
+        frame.syscalls += syscalls;
+        ++frame.wakeups;
+      }
     }
   }
 }
 
 void Tui::clear()
 {
-  // clear screen
-  _ctx.buf
-  << aec::cursor_home
-  << _ctx.style.background;
-
-  OB::Algorithm::for_each(_ctx.height,
-  [&](auto) {
-    OB::Algorithm::for_each(_ctx.width, [&](auto) {
-      _ctx.buf << " "; });
-    _ctx.buf << "\n";
-  },
-  [&](auto) {
-    OB::Algorithm::for_each(_ctx.width, [&](auto) {
-      _ctx.buf << " "; });
-  });
-
-  _ctx.buf
-  << aec::clear
-  << aec::cursor_home;
+  // reset the framebuffer to the background, nothing is output here,
+  // refresh only outputs the cells that end up different on screen
+  _ctx.grid.size(_ctx.width, _ctx.height);
+  _ctx.grid.clear(_ctx.style.background.value());
 }
 
 void Tui::refresh()
 {
-  // output buffer to screen
-  std::cout
-  << _ctx.buf.str()
-  << std::flush;
+  auto const begin = Stats::clock::now();
+  auto& throttle = _ctx.output.throttle;
+  throttle.budget(static_cast<std::size_t>(_ctx.output.rate.get()));
+
+  if (_ctx.stats)
+  {
+    // the ioctl for the queued output
+    ++_ctx.stats->frame().syscalls;
+  }
 
-  // clear output buffer
-  _ctx.buf.str("");
+  // a frame written behind queued output would show a time that has passed
+  // by the time it is seen, its changes stay in the grid for the next frame
+  if (throttle.blocked(output_queued(), begin))
+  {
+    _ctx.output.retry = _ctx.time +
+      std::chrono::duration_cast<wall_clock::duration>(throttle.wait());
+    _peaclock.reduce(static_cast<Peaclock::Reduce::Type>(throttle.level()));
+
+    return;
+  }
+
+  _ctx.output.retry = {};
+
+  if (_ctx.sync)
+  {
+    _ctx.buf << aec::sync_begin;
+  }
+
+  auto const size = _ctx.buf.size();
+
+  // output changed cells to screen in a single write
+  _ctx.grid.flush(_ctx.buf);
+
+  if (_ctx.buf.size() == size)
+  {
+    _ctx.buf.clear();
+
+    return;
+  }
+
+  if (_ctx.sync)
+  {
+    _ctx.buf << aec::sync_end;
+  }
+
+  auto const write_begin = Stats::clock::now();
+
+  // the terminal went away
+  if (! _ctx.buf.write(STDOUT_FILENO))
+  {
+    _ctx.is_running = false;
+  }
+
+  // a write that blocked, or output still queued, measures the terminal,
+  // the reduction applies from the next frame
+  auto const write_end = Stats::clock::now();
+  throttle.wrote(_ctx.buf.size(), write_end - write_begin, output_queued(), write_end);
+  _peaclock.reduce(static_cast<Peaclock::Reduce::Type>(throttle.level()));
+
+  if (_ctx.stats)
+  {
+    auto& frame = _ctx.stats->frame();
+    frame.write += write_end - begin;
+    frame.bytes += _ctx.buf.size();
+
+    // the write of the flush, and the ioctl for the queued output after it
+    frame.syscalls += 2;
+  }
+
+  // clear output buffer, keeping its capacity for the next frame
+  _ctx.buf.clear();
 }
 
 void Tui::draw()
@@ -305,19 +1287,45 @@ void Tui::draw()
   draw_content();
   draw_prompt_message();
   draw_keybuf();
+  draw_stats();
 }
 
 void Tui::draw_content()
 {
-  _ctx.buf
-  << aec::cursor_save;
+  if (! _ctx.stats)
+  {
+    // render new content
+    _peaclock.render(_ctx.width, _ctx.height, _ctx.grid, wall_clock::to_time_t(_ctx.time));
+
+    return;
+  }
+
+  // render new content, timing each stage
+  auto& frame = _ctx.stats->frame();
+  auto const begin = Stats::clock::now();
+
+  _peaclock.layout(_ctx.width, _ctx.height, wall_clock::to_time_t(_ctx.time));
+  auto const mid = Stats::clock::now();
+
+  _peaclock.draw(_ctx.grid);
+
+  frame.layout += mid - begin;
+  frame.render += Stats::clock::now() - mid;
+}
+
+void Tui::draw_stats()
+{
+  if (! _ctx.stats || ! _ctx.stats->overlay)
+  {
+    return;
+  }
 
-  // render new content
-  _peaclock.render(_ctx.width, _ctx.height, _ctx.buf);
+  auto const str = _ctx.stats->str_short();
+  auto const cols = std::min(str.size(), _ctx.width);
 
-  _ctx.buf
-  << aec::clear
-  << aec::cursor_load;
+  _ctx.grid.text(_ctx.width - cols, 0, std::string_view(str).substr(0, cols),
+    _ctx.grid.style(_ctx.style.text.value()),
+    _ctx.grid.style(_ctx.style.background.value()));
 }
 
 void Tui::draw_keybuf()
@@ -327,46 +1335,37 @@ void Tui::draw_keybuf()
     return;
   }
 
-  _ctx.buf
-  << aec::cursor_save
-  << aec::cursor_set(_ctx.width - 3, _ctx.height)
-  << _ctx.style.background
-  << "    "
-  << aec::cursor_set(_ctx.width - 3, _ctx.height)
-  << _ctx.style.text
-  << aec::space;
+  auto const fg = _ctx.grid.style(_ctx.style.text.value());
+  auto const bg = _ctx.grid.style(_ctx.style.background.value());
+
+  std::string str {aec::space};
 
   for (auto const& e : _ctx.keys)
   {
     if (OB::Text::is_print(static_cast<std::int32_t>(e.val)))
     {
-      _ctx.buf
-      << e.str;
+      str += e.str;
     }
   }
 
-  _ctx.buf
-  << aec::space
-  << aec::clear
-  << aec::cursor_load;
+  str += aec::space;
+
+  _ctx.grid.fill(_ctx.width - 4, _ctx.height - 1, 4, 1, " ", 0, bg);
+  _ctx.grid.text(_ctx.width - 4, _ctx.height - 1, str, fg, bg);
 }
 
 void Tui::draw_prompt_message()
 {
   // check if command prompt message is active
-  if (_ctx.prompt.count > 0)
+  if (_ctx.prompt.until > _ctx.time)
   {
-    --_ctx.prompt.count;
+    auto const bg = _ctx.grid.style(_ctx.style.background.value());
+
+    auto const cols = _ctx.grid.text(0, _ctx.height - 1, ">",
+      _ctx.grid.style(_ctx.style.prompt.value()), bg);
 
-    _ctx.buf
-    << aec::cursor_save
-    << aec::cursor_set(0, _ctx.height)
-    << _ctx.style.background
-    << _ctx.style.prompt
-    << ">"
-    << _ctx.style.prompt_status
-    << _ctx.prompt.str.substr(0, _ctx.width - 5)
-    << aec::cursor_load;
+    _ctx.grid.text(cols, _ctx.height - 1, _ctx.prompt.str.substr(0, _ctx.width - 5),
+      _ctx.grid.style(_ctx.style.prompt_status.value()), bg);
   }
 }
 
@@ -374,7 +1373,7 @@ void Tui::set_status(bool success, std::string const& msg)
 {
   _ctx.style.prompt_status = success ? _ctx.style.success : _ctx.style.error;
   _ctx.prompt.str = msg;
-  _ctx.prompt.count = _ctx.prompt.timeout;
+  _ctx.prompt.until = wall_clock::now() + std::chrono::milliseconds(_ctx.prompt.rate.get());
 }
 
 void Tui::get_input()
@@ -404,7 +1403,7 @@ void Tui::get_input()
 
       case OB::Term::Key::escape:
       {
-        _ctx.prompt.count = 0;
+        _ctx.prompt.until = {};
         _ctx.keys.clear();
 
         break;
@@ -1186,17 +2185,14 @@ void Tui::get_input()
       default:
       {
         // ignore
-        draw_keybuf();
-        refresh();
         _ctx.keys.clear();
 
         return;
       }
     }
 
-    clear();
-    draw();
-    refresh();
+    // the event loop redraws once the keys have been read
+    _peaclock.cfg_changed();
     _ctx.keys.clear();
   }
 
@@ -1218,767 +2214,708 @@ std::optional<std::pair<bool, std::string>> Tui::command(std::string const& inpu
     return {};
   }
 
-  auto const keys = OB::String::split(input, " ", 2);
-
-  if (keys.empty())
-  {
-    return {};
-  }
+  using Result = std::optional<std::pair<bool, std::string>>;
 
-  // store the matches returned from OB::String::match
-  std::optional<std::vector<std::string>> match_opt;
+  // called with the arguments that follow the command name,
+  // returns empty when the command changed the config
+  using Handler = Result (*)(Tui& tui, std::string_view args, std::string const& line);
 
-  // quit
-  if (keys.size() == 1 && (keys.at(0) == "q" || keys.at(0) == "Q" ||
-    keys.at(0) == "quit" || keys.at(0) == "Quit" || keys.at(0) == "exit"))
+  // colours that can be set with the style command
+  struct Style_Key
   {
-    _ctx.is_running = false;
-    return {};
-  }
+    OB::Color& (*color)(Tui& tui);
+    OB::Color::Type::value type;
+  };
 
-  else if (keys.at(0) == "rate-input" && (match_opt = OB::String::match(input,
-    std::regex("^rate-input(?:\\s+([0-9]+))?$"))))
+  static std::unordered_map<std::string_view, Style_Key> const styles
   {
-    auto const match = match_opt.value().at(1);
+    {"active-fg", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.active_fg; }, OB::Color::Type::fg}},
+    {"active-bg", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.active_bg; }, OB::Color::Type::bg}},
+    {"inactive-fg", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.inactive_fg; }, OB::Color::Type::fg}},
+    {"inactive-bg", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.inactive_bg; }, OB::Color::Type::bg}},
+    {"colon-fg", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.colon_fg; }, OB::Color::Type::fg}},
+    {"colon-bg", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.colon_bg; }, OB::Color::Type::bg}},
+    {"date", {+[](Tui& tui) -> OB::Color& {
+      return tui._peaclock.cfg.style.date; }, OB::Color::Type::fg}},
+    {"text", {+[](Tui& tui) -> OB::Color& {
+      return tui._ctx.style.text; }, OB::Color::Type::fg}},
+    {"background", {+[](Tui& tui) -> OB::Color& {
+      return tui._ctx.style.background; }, OB::Color::Type::bg}},
+    {"prompt", {+[](Tui& tui) -> OB::Color& {
+      return tui._ctx.style.prompt; }, OB::Color::Type::fg}},
+    {"success", {+[](Tui& tui) -> OB::Color& {
+      return tui._ctx.style.success; }, OB::Color::Type::fg}},
+    {"error", {+[](Tui& tui) -> OB::Color& {
+      return tui._ctx.style.error; }, OB::Color::Type::fg}},
+  };
+
+  // toggles that can be changed with the set command
+  static std::unordered_map<std::string_view, bool& (*)(Tui& tui)> const toggles
+  {
+    {"date", [](Tui& tui) -> bool& { return tui._peaclock.cfg.date; }},
+    {"seconds", [](Tui& tui) -> bool& { return tui._peaclock.cfg.seconds; }},
+    {"hour-24", [](Tui& tui) -> bool& { return tui._peaclock.cfg.hour_24; }},
+    {"auto-size", [](Tui& tui) -> bool& { return tui._peaclock.cfg.auto_size; }},
+    {"auto-ratio", [](Tui& tui) -> bool& { return tui._peaclock.cfg.auto_ratio; }},
+  };
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "rate-input " + _ctx.input_interval.str());
-    }
-    else
+  static constexpr auto quit = [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+    if (! args.empty())
     {
-      _ctx.input_interval = std::stoi(match);
+      return unknown(line);
     }
-  }
 
-  else if (keys.at(0) == "rate-refresh" && (match_opt = OB::String::match(input,
-    std::regex("^rate-refresh(?:\\s+([0-9]+))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+    tui._ctx.is_running = false;
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "rate-refresh " + _ctx.refresh_rate.str());
-    }
-    else
-    {
-      _ctx.refresh_rate = std::stoi(match);
-      _ctx.prompt.timeout = _ctx.prompt.rate.get() / _ctx.refresh_rate.get();
-    }
-  }
+    return {};
+  };
 
-  else if (keys.at(0) == "rate-status" && (match_opt = OB::String::match(input,
-    std::regex("^rate-status(?:\\s+([0-9]+))?$"))))
+  // commands indexed by name, built once on first use
+  static std::unordered_map<std::string_view, Handler> const commands
   {
-    auto const match = match_opt.value().at(1);
+    // quit
+    {"q", quit},
+    {"Q", quit},
+    {"quit", quit},
+    {"Quit", quit},
+    {"exit", quit},
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "rate-status " + _ctx.prompt.rate.str());
-    }
-    else
-    {
-      _ctx.prompt.rate = std::stoi(match);
-      _ctx.prompt.timeout = _ctx.prompt.rate.get() / _ctx.refresh_rate.get();
-    }
-  }
+    {"rate-input", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "rate-input " + tui._ctx.input_interval.str());
+      }
 
-  else if (keys.at(0) == "locale" && (match_opt = OB::String::match(input,
-    std::regex("^locale(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      auto const val = parse_int(args);
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "locale '" + _peaclock.cfg.locale + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      if (! val)
       {
-        _peaclock.cfg.locale = "";
+        return unknown(line);
       }
-      else if (! _peaclock.cfg_locale(match.substr(1, match.size() - 2)))
+
+      tui._ctx.input_interval = val.value();
+
+      return {};
+    }},
+
+    {"rate-refresh", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(false, "error: invalid locale '" + match + "'");
+        return std::make_pair(true, "rate-refresh " + tui._ctx.refresh_rate.str());
       }
-    }
-  }
 
-  else if (keys.at(0) == "timezone" && (match_opt = OB::String::match(input,
-    std::regex("^timezone(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      auto const val = parse_int(args);
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "timezone '" + _peaclock.cfg.timezone + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      if (! val)
+      {
+        return unknown(line);
+      }
+
+      tui._ctx.refresh_rate = val.value();
+
+      return {};
+    }},
+
+    {"rate-status", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        _peaclock.cfg.timezone = "";
+        return std::make_pair(true, "rate-status " + tui._ctx.prompt.rate.str());
       }
-      else if (! _peaclock.cfg_timezone(match.substr(1, match.size() - 2)))
+
+      auto const val = parse_int(args);
+
+      if (! val)
       {
-        return std::make_pair(false, "error: invalid timezone '" + match + "'");
+        return unknown(line);
       }
-    }
-  }
 
-  else if (keys.at(0) == "date" && (match_opt = OB::String::match(input,
-    std::regex("^date(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      tui._ctx.prompt.rate = val.value();
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "date '" + OB::String::escape(_peaclock.cfg.datefmt) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      return {};
+    }},
+
+    {"rate-animation", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "rate-animation " + tui._peaclock.cfg.rate_animation.str());
+      }
+
+      auto const val = parse_int(args);
+
+      if (! val)
+      {
+        return unknown(line);
+      }
+
+      tui._peaclock.cfg.rate_animation = val.value();
+
+      return {};
+    }},
+
+    {"rate-output", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "rate-output " + tui._ctx.output.rate.str());
+      }
+
+      auto const val = parse_int(args);
+
+      if (! val)
+      {
+        return unknown(line);
+      }
+
+      tui._ctx.output.rate = val.value();
+
+      return {};
+    }},
+
+    {"colour-depth", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "colour-depth " +
+          (tui._ctx.colour_depth ? std::to_string(tui._ctx.colour_depth) : "auto"s));
+      }
+
+      auto const val = parse_enum(args, {"auto", "24", "8", "4"});
+
+      if (! val)
+      {
+        return unknown(line);
+      }
+
+      tui._ctx.colour_depth = std::array<std::size_t, 4> {0, 24, 8, 4}.at(val.value());
+      tui._ctx.grid.depth(tui.colour_depth());
+
+      return {};
+    }},
+
+    {"stats", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, tui._ctx.stats ? tui._ctx.stats->str() : "stats off");
+      }
+
+      auto const val = parse_enum(args, {"on", "off", "overlay"});
+
+      if (! val)
+      {
+        return unknown(line);
+      }
+
+      if (val.value() == 1)
+      {
+        tui._ctx.stats.reset();
+      }
+      else
+      {
+        if (! tui._ctx.stats)
+        {
+          tui._ctx.stats.emplace();
+        }
+
+        tui._ctx.stats->overlay = val.value() == 2;
+      }
+
+      return {};
+    }},
+
+    {"locale", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "locale '" + tui._peaclock.cfg.locale + "'");
+      }
+
+      auto const val = parse_str(args);
+
+      if (! val)
+      {
+        return unknown(line);
+      }
+
+      if (val.value().empty())
       {
-        _peaclock.cfg.datefmt = "";
+        tui._peaclock.cfg.locale = "";
       }
-      else
+      else if (! tui._peaclock.cfg_locale(std::string(val.value())))
       {
-        _peaclock.cfg_datefmt(OB::String::unescape(match.substr(1, match.size() - 2)));
+        return std::make_pair(false, "error: invalid locale '" + std::string(args) + "'");
       }
-    }
-  }
 
-  else if (keys.at(0) == "fill" && (match_opt = OB::String::match(input,
-    std::regex("^fill(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      return {};
+    }},
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill '" + OB::String::escape(_peaclock.cfg.fill_active) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+    {"timezone", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        _peaclock.cfg.fill_active = "";
-        _peaclock.cfg.fill_inactive = "";
-        _peaclock.cfg.fill_colon = "";
+        return std::make_pair(true, "timezone '" + tui._peaclock.cfg.timezone + "'");
       }
-      else
+
+      auto const val = parse_str(args);
+
+      if (! val)
       {
-        _peaclock.cfg.fill_active = OB::String::unescape(match.substr(1, match.size() - 2));
-        _peaclock.cfg.fill_inactive = _peaclock.cfg.fill_active;
-        _peaclock.cfg.fill_colon = _peaclock.cfg.fill_active;
+        return unknown(line);
       }
-    }
-  }
-
-  else if (keys.at(0) == "fill-active" && (match_opt = OB::String::match(input,
-    std::regex("^fill-active(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill-active '" + OB::String::escape(_peaclock.cfg.fill_active) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      if (val.value().empty())
       {
-        _peaclock.cfg.fill_active = "";
+        tui._peaclock.cfg.timezone = "";
       }
-      else
+      else if (! tui._peaclock.cfg_timezone(std::string(val.value())))
       {
-        _peaclock.cfg.fill_active = OB::String::unescape(match.substr(1, match.size() - 2));
+        return std::make_pair(false, "error: invalid timezone '" + std::string(args) + "'");
       }
-    }
-  }
 
-  else if (keys.at(0) == "fill-inactive" && (match_opt = OB::String::match(input,
-    std::regex("^fill-inactive(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      return {};
+    }},
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill-inactive '" + OB::String::escape(_peaclock.cfg.fill_inactive) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+    {"date", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        _peaclock.cfg.fill_inactive = "";
+        return std::make_pair(true, "date '" + OB::String::escape(tui._peaclock.cfg.datefmt) + "'");
       }
-      else
+
+      auto const val = parse_str(args);
+
+      if (! val)
       {
-        _peaclock.cfg.fill_inactive = OB::String::unescape(match.substr(1, match.size() - 2));
+        return unknown(line);
       }
-    }
-  }
 
-  else if (keys.at(0) == "fill-colon" && (match_opt = OB::String::match(input,
-    std::regex("^fill-colon(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill-colon '" + OB::String::escape(_peaclock.cfg.fill_colon) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      if (val.value().empty())
       {
-        _peaclock.cfg.fill_colon = "";
+        tui._peaclock.cfg.datefmt = "";
       }
       else
       {
-        _peaclock.cfg.fill_colon = OB::String::unescape(match.substr(1, match.size() - 2));
+        tui._peaclock.cfg_datefmt(OB::String::unescape(std::string(val.value())));
       }
-    }
-  }
 
-  else if (keys.at(0) == "mode" && (match_opt = OB::String::match(input,
-    std::regex("^mode(?:\\s+(date|digital|binary|icon))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      return {};
+    }},
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "mode " + Peaclock::Mode::str(_peaclock.cfg.mode));
-    }
-    else
-    {
-      _peaclock.cfg.mode = Peaclock::Mode::enm(match);
-    }
-  }
+    {"fill", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "fill '" + OB::String::escape(tui._peaclock.cfg.fill_active) + "'");
+      }
 
-  else if (keys.at(0) == "toggle" && (match_opt = OB::String::match(input,
-    std::regex("^toggle(?:\\s+(block|padding|margin|ratio|active-fg|inactive-fg|colon-fg|active-bg|inactive-bg|colon-bg|date|background))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      auto const val = parse_str(args);
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "toggle " + Peaclock::Toggle::str(_peaclock.cfg.toggle));
-    }
-    else
-    {
-      _peaclock.cfg.toggle = Peaclock::Toggle::enm(match);
-    }
-  }
+      if (! val)
+      {
+        return unknown(line);
+      }
 
-  else if (keys.at(0) == "block" && (match_opt = OB::String::match(input,
-    std::regex("^block(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
+      tui._peaclock.cfg.fill_active = OB::String::unescape(std::string(val.value()));
+      tui._peaclock.cfg.fill_inactive = tui._peaclock.cfg.fill_active;
+      tui._peaclock.cfg.fill_colon = tui._peaclock.cfg.fill_active;
 
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "block " + _peaclock.cfg.x_block.str() + " " + _peaclock.cfg.y_block.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_block = std::stoul(x);
-      _peaclock.cfg.y_block = std::stoul(y);
-    }
-  }
+      return {};
+    }},
 
-  else if (keys.at(0) == "block-x" && (match_opt = OB::String::match(input,
-    std::regex("^block-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
+    {"fill-active", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "fill-active '" + OB::String::escape(tui._peaclock.cfg.fill_active) + "'");
+      }
 
-    if (x.empty())
-    {
-      return std::make_pair(true, "block-x " + _peaclock.cfg.x_block.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_block = std::stoul(x);
-    }
-  }
+      auto const val = parse_str(args);
 
-  else if (keys.at(0) == "block-y" && (match_opt = OB::String::match(input,
-    std::regex("^block-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
+      if (! val)
+      {
+        return unknown(line);
+      }
 
-    if (y.empty())
-    {
-      return std::make_pair(true, "block-y " + _peaclock.cfg.y_block.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_block = std::stoul(y);
-    }
-  }
+      tui._peaclock.cfg.fill_active = OB::String::unescape(std::string(val.value()));
 
-  else if (keys.at(0) == "padding" && (match_opt = OB::String::match(input,
-    std::regex("^padding(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
+      return {};
+    }},
 
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "padding " + _peaclock.cfg.x_space.str() + " " + _peaclock.cfg.y_space.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_space = std::stoul(x);
-      _peaclock.cfg.y_space = std::stoul(y);
-    }
-  }
+    {"fill-inactive", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "fill-inactive '" + OB::String::escape(tui._peaclock.cfg.fill_inactive) + "'");
+      }
 
-  else if (keys.at(0) == "padding-x" && (match_opt = OB::String::match(input,
-    std::regex("^padding-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
+      auto const val = parse_str(args);
 
-    if (x.empty())
-    {
-      return std::make_pair(true, "padding-x " + _peaclock.cfg.x_space.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_space = std::stoul(x);
-    }
-  }
+      if (! val)
+      {
+        return unknown(line);
+      }
 
-  else if (keys.at(0) == "padding-y" && (match_opt = OB::String::match(input,
-    std::regex("^padding-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
+      tui._peaclock.cfg.fill_inactive = OB::String::unescape(std::string(val.value()));
 
-    if (y.empty())
-    {
-      return std::make_pair(true, "padding-y " + _peaclock.cfg.y_space.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_space = std::stoul(y);
-    }
-  }
+      return {};
+    }},
 
-  else if (keys.at(0) == "margin" && (match_opt = OB::String::match(input,
-    std::regex("^margin(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
+    {"fill-colon", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "fill-colon '" + OB::String::escape(tui._peaclock.cfg.fill_colon) + "'");
+      }
 
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "margin " + _peaclock.cfg.x_border.str() + " " + _peaclock.cfg.y_border.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_border = std::stoul(x);
-      _peaclock.cfg.y_border = std::stoul(y);
-    }
-  }
+      auto const val = parse_str(args);
 
-  else if (keys.at(0) == "margin-x" && (match_opt = OB::String::match(input,
-    std::regex("^margin-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
+      if (! val)
+      {
+        return unknown(line);
+      }
 
-    if (x.empty())
-    {
-      return std::make_pair(true, "margin-x " + _peaclock.cfg.x_border.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_border = std::stoul(x);
-    }
-  }
+      tui._peaclock.cfg.fill_colon = OB::String::unescape(std::string(val.value()));
 
-  else if (keys.at(0) == "margin-y" && (match_opt = OB::String::match(input,
-    std::regex("^margin-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
+      return {};
+    }},
 
-    if (y.empty())
-    {
-      return std::make_pair(true, "margin-y " + _peaclock.cfg.y_border.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_border = std::stoul(y);
-    }
-  }
+    {"mode", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "mode " + Peaclock::Mode::str(tui._peaclock.cfg.mode));
+      }
 
-  else if (keys.at(0) == "ratio" && (match_opt = OB::String::match(input,
-    std::regex("^ratio(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
+      if (! parse_enum(args, {"date", "digital", "binary", "icon"}))
+      {
+        return unknown(line);
+      }
 
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "ratio " + _peaclock.cfg.x_ratio.str() + " " + _peaclock.cfg.y_ratio.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_ratio = std::stoul(x);
-      _peaclock.cfg.y_ratio = std::stoul(y);
-    }
-  }
+      tui._peaclock.cfg.mode = Peaclock::Mode::enm(std::string(args));
 
-  else if (keys.at(0) == "ratio-x" && (match_opt = OB::String::match(input,
-    std::regex("^ratio-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
+      return {};
+    }},
 
-    if (x.empty())
-    {
-      return std::make_pair(true, "ratio-x " + _peaclock.cfg.x_ratio.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_ratio = std::stoul(x);
-    }
-  }
+    {"toggle", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
+      {
+        return std::make_pair(true, "toggle " + Peaclock::Toggle::str(tui._peaclock.cfg.toggle));
+      }
 
-  else if (keys.at(0) == "ratio-y" && (match_opt = OB::String::match(input,
-    std::regex("^ratio-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
+      if (! parse_enum(args, {"block", "padding", "margin", "ratio", "active-fg",
+        "inactive-fg", "colon-fg", "active-bg", "inactive-bg", "colon-bg", "date", "background"}))
+      {
+        return unknown(line);
+      }
 
-    if (y.empty())
-    {
-      return std::make_pair(true, "ratio-y " + _peaclock.cfg.y_ratio.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_ratio = std::stoul(y);
-    }
-  }
+      tui._peaclock.cfg.toggle = Peaclock::Toggle::enm(std::string(args));
 
-  else if (keys.size() >= 2 && keys.at(0) == "style")
-  {
-    if (keys.at(1) == "active-fg")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"block", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style active-fg " + _peaclock.cfg.style.active_fg.key());
+        return std::make_pair(true, "block " + tui._peaclock.cfg.x_block.str() + " " + tui._peaclock.cfg.y_block.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int_pair(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.active_fg = color;
-    }
+      tui._peaclock.cfg.x_block = static_cast<std::size_t>(val.value().first);
+      tui._peaclock.cfg.y_block = static_cast<std::size_t>(val.value().second);
 
-    else if (keys.at(1) == "active-bg")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"block-x", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style active-bg " + _peaclock.cfg.style.active_bg.key());
+        return std::make_pair(true, "block-x " + tui._peaclock.cfg.x_block.str());
       }
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.active_bg = color;
-    }
+      tui._peaclock.cfg.x_block = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "inactive-fg")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"block-y", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style inactive-fg " + _peaclock.cfg.style.inactive_fg.key());
+        return std::make_pair(true, "block-y " + tui._peaclock.cfg.y_block.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.inactive_fg = color;
-    }
+      tui._peaclock.cfg.y_block = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "inactive-bg")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"padding", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style inactive-bg " + _peaclock.cfg.style.inactive_bg.key());
+        return std::make_pair(true, "padding " + tui._peaclock.cfg.x_space.str() + " " + tui._peaclock.cfg.y_space.str());
       }
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+      auto const val = parse_int_pair(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.inactive_bg = color;
-    }
+      tui._peaclock.cfg.x_space = static_cast<std::size_t>(val.value().first);
+      tui._peaclock.cfg.y_space = static_cast<std::size_t>(val.value().second);
 
-    else if (keys.at(1) == "colon-fg")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"padding-x", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style colon-fg " + _peaclock.cfg.style.colon_fg.key());
+        return std::make_pair(true, "padding-x " + tui._peaclock.cfg.x_space.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.colon_fg = color;
-    }
+      tui._peaclock.cfg.x_space = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "colon-bg")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"padding-y", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style colon-bg " + _peaclock.cfg.style.colon_bg.key());
+        return std::make_pair(true, "padding-y " + tui._peaclock.cfg.y_space.str());
       }
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.colon_bg = color;
-    }
+      tui._peaclock.cfg.y_space = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "date")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"margin", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style date " + _peaclock.cfg.style.date.key());
+        return std::make_pair(true, "margin " + tui._peaclock.cfg.x_border.str() + " " + tui._peaclock.cfg.y_border.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int_pair(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _peaclock.cfg.style.date = color;
-    }
+      tui._peaclock.cfg.x_border = static_cast<std::size_t>(val.value().first);
+      tui._peaclock.cfg.y_border = static_cast<std::size_t>(val.value().second);
 
-    else if (keys.at(1) == "text")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"margin-x", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style text " + _ctx.style.text.key());
+        return std::make_pair(true, "margin-x " + tui._peaclock.cfg.x_border.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _ctx.style.text = color;
-    }
+      tui._peaclock.cfg.x_border = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "background")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"margin-y", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style background " + _ctx.style.background.key());
+        return std::make_pair(true, "margin-y " + tui._peaclock.cfg.y_border.str());
       }
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _ctx.style.background = color;
-      _peaclock.cfg.style.background = color;
-    }
+      tui._peaclock.cfg.y_border = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "prompt")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"ratio", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style prompt " + _ctx.style.prompt.key());
+        return std::make_pair(true, "ratio " + tui._peaclock.cfg.x_ratio.str() + " " + tui._peaclock.cfg.y_ratio.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int_pair(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _ctx.style.prompt = color;
-    }
+      tui._peaclock.cfg.x_ratio = static_cast<std::size_t>(val.value().first);
+      tui._peaclock.cfg.y_ratio = static_cast<std::size_t>(val.value().second);
 
-    else if (keys.at(1) == "success")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"ratio-x", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style success " + _ctx.style.success.key());
+        return std::make_pair(true, "ratio-x " + tui._peaclock.cfg.x_ratio.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _ctx.style.success = color;
-    }
+      tui._peaclock.cfg.x_ratio = static_cast<std::size_t>(val.value());
 
-    else if (keys.at(1) == "error")
-    {
-      if (keys.size() < 3)
+      return {};
+    }},
+
+    {"ratio-y", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      if (args.empty())
       {
-        return std::make_pair(true, "style error " + _ctx.style.error.key());
+        return std::make_pair(true, "ratio-y " + tui._peaclock.cfg.y_ratio.str());
       }
 
-      OB::Color color {keys.at(2)};
+      auto const val = parse_int(args);
 
-      if (! color)
+      if (! val)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return unknown(line);
       }
 
-      _ctx.style.error = color;
-    }
+      tui._peaclock.cfg.y_ratio = static_cast<std::size_t>(val.value());
 
-    else
-    {
-      return std::make_pair(false, "warning: unknown command '" + input + "'");
-    }
-  }
+      return {};
+    }},
 
-  else if (keys.size() >= 2 && keys.at(0) == "set")
-  {
-    if (match_opt = OB::String::match(input,
-      std::regex("^set\\s+date(?:\\s+(true|false|t|f|1|0|on|off))?$")))
-    {
-      auto const match = match_opt.value().at(1);
+    {"style", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      auto const [key, val] = parse_word(args);
+      auto const it = styles.find(key);
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set date "s + btos(_peaclock.cfg.date));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.date = true;
-      }
-      else
+      if (it == styles.end())
       {
-        _peaclock.cfg.date = false;
+        return unknown(line);
       }
-    }
 
-    else if (match_opt = OB::String::match(input,
-      std::regex("^set\\s+seconds(?:\\s+(true|false|t|f|1|0|on|off))?$")))
-    {
-      auto const match = match_opt.value().at(1);
+      auto& color = it->second.color(tui);
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set seconds "s + btos(_peaclock.cfg.seconds));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.seconds = true;
-      }
-      else
+      if (val.empty())
       {
-        _peaclock.cfg.seconds = false;
+        return std::make_pair(true, "style " + std::string(key) + " " + color.key());
       }
-    }
 
-    else if (match_opt = OB::String::match(input,
-      std::regex("^set\\s+hour-24(?:\\s+(true|false|t|f|1|0|on|off))?$")))
-    {
-      auto const match = match_opt.value().at(1);
+      OB::Color res {std::string(val), it->second.type};
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set hour-24 "s + btos(_peaclock.cfg.hour_24));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.hour_24 = true;
-      }
-      else
+      if (! res)
       {
-        _peaclock.cfg.hour_24 = false;
+        return unknown(line);
       }
-    }
 
-    else if (match_opt = OB::String::match(input,
-      std::regex("^set\\s+auto-size(?:\\s+(true|false|t|f|1|0|on|off))?$")))
-    {
-      auto const match = match_opt.value().at(1);
+      color = res;
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set auto-size "s + btos(_peaclock.cfg.auto_size));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
+      if (key == "background")
       {
-        _peaclock.cfg.auto_size = true;
+        tui._peaclock.cfg.style.background = res;
       }
-      else
-      {
-        _peaclock.cfg.auto_size = false;
-      }
-    }
 
-    else if (match_opt = OB::String::match(input,
-      std::regex("^set\\s+auto-ratio(?:\\s+(true|false|t|f|1|0|on|off))?$")))
-    {
-      auto const match = match_opt.value().at(1);
+      return {};
+    }},
+
+    {"set", [](Tui& tui, std::string_view args, std::string const& line) -> Result {
+      auto const [key, val] = parse_word(args);
+      auto const it = toggles.find(key);
 
-      if (match.empty())
+      if (it == toggles.end())
       {
-        return std::make_pair(true, "set auto-ratio "s + btos(_peaclock.cfg.auto_ratio));
+        return unknown(line);
       }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
+
+      auto& toggle = it->second(tui);
+
+      if (val.empty())
       {
-        _peaclock.cfg.auto_ratio = true;
+        return std::make_pair(true, "set " + std::string(key) + " " + btos(toggle));
       }
-      else
+
+      auto const res = parse_bool(val);
+
+      if (! res)
       {
-        _peaclock.cfg.auto_ratio = false;
+        return unknown(line);
       }
-    }
 
-    else
-    {
-      return std::make_pair(false, "warning: unknown command '" + input + "'");
-    }
+      toggle = res.value();
+
+      return {};
+    }},
+  };
+
+  // the command name ends at the first space, the arguments begin after the
+  // whitespace that follows it
+  auto const pos = input.find(' ');
+  auto const [name, args] = parse_word(input);
+
+  if (name.size() != std::min(pos, input.size()) ||
+    (pos != std::string::npos && args.empty()))
+  {
+    return unknown(input);
   }
 
-  // unknown
-  else
+  auto const it = commands.find(name);
+
+  if (it == commands.end())
+  {
+    return unknown(input);
+  }
+
+  if (auto res = it->second(*this, args, input))
   {
-    return std::make_pair(false, "warning: unknown command '" + input + "'");
+    return res;
+  }
+
+  if (_ctx.is_running)
+  {
+    _peaclock.cfg_changed();
   }
 
   return {};
@@ -1986,8 +2923,8 @@ std::optional<std::pair<bool, std::string>> Tui::command(std::string const& inpu
 
 void Tui::command_prompt()
 {
-  // reset prompt message count
-  _ctx.prompt.count = 0;
+  // hide the prompt message
+  _ctx.prompt.until = {};
 
   // set prompt style
   _readline.style(_ctx.style.text.value() + _ctx.style.background.value());
@@ -2008,6 +2945,9 @@ void Tui::command_prompt()
   << aec::cursor_load
   << std::flush;
 
+  // the prompt line was drawn outside of the framebuffer
+  _ctx.grid.invalidate();
+
   if (auto const res = command(input))
   {
     set_status(res.value().first, res.value().second);
@@ -2023,13 +2963,11 @@ int Tui::screen_size()
   {
     clear();
 
-    _ctx.buf
-    << _ctx.style.background
-    << _ctx.style.error;
+    std::ostringstream msg;
 
     if (width_invalid && height_invalid)
     {
-      _ctx.buf
+      msg
       << "Error: width "
       << _ctx.width
       << " (min "
@@ -2042,7 +2980,7 @@ int Tui::screen_size()
     }
     else if (width_invalid)
     {
-      _ctx.buf
+      msg
       << "Error: width "
       << _ctx.width
       << " (min "
@@ -2051,7 +2989,7 @@ int Tui::screen_size()
     }
     else
     {
-      _ctx.buf
+      msg
       << "Error: height "
       << _ctx.height
       << " (min "
@@ -2059,8 +2997,8 @@ int Tui::screen_size()
       << ")";
     }
 
-    _ctx.buf
-    << aec::clear;
+    _ctx.grid.text(0, 0, msg.str(), _ctx.grid.style(_ctx.style.error.value()),
+      _ctx.grid.style(_ctx.style.background.value()));
 
     refresh();
 
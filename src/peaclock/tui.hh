@@ -2,22 +2,33 @@
 #define TUI_HH
 
 #include "peaclock/peaclock.hh"
+#include "peaclock/stats.hh"
+#include "peaclock/throttle.hh"
 
 #include "ob/num.hh"
+#include "ob/buffer.hh"
 #include "ob/color.hh"
+#include "ob/file_watch.hh"
+#include "ob/grid.hh"
 #include "ob/readline.hh"
+#include "ob/signal.hh"
 #include "ob/string.hh"
 #include "ob/text.hh"
 #include "ob/term.hh"
+#include "ob/timer.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
+#include <ctime>
 #include <cstdio>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <chrono>
+#include <unordered_map>
 #include <sstream>
 #include <utility>
 #include <optional>
@@ -37,17 +48,35 @@ public:
   void load_hist_command(fs::path const& path);
   void run();
 
+  // run a single command, returns the status and message if it produced one
+  std::optional<std::pair<bool, std::string>> command(std::string const& input);
+
+  // render without a terminal, config errors are fatal instead of prompting
+  void headless(bool const val);
+
+  // keep a binary snapshot of the settings next to the config file,
+  // loaded instead of parsing the config while the file is unchanged
+  void config_cache(bool const val);
+
+  // render a single frame at a fixed time, returns the output bytes
+  std::string render_once(std::size_t const width, std::size_t const height,
+    std::time_t const time);
+
 private:
 
   void get_input();
   bool press_to_continue(std::string const& str = "ANY KEY", char32_t val = 0);
 
-  std::optional<std::pair<bool, std::string>> command(std::string const& input);
   void command_prompt();
 
   void event_loop();
   int screen_size();
 
+  using wall_clock = OB::Timer::clock;
+
+  // wall clock time the next frame is due, when the output would change
+  wall_clock::time_point next_frame() const;
+
   void clear();
   void refresh();
 
@@ -55,10 +84,43 @@ private:
   void draw_content();
   void draw_prompt_message();
   void draw_keybuf();
+  void draw_stats();
 
   void set_status(bool success, std::string const& msg);
 
-  OB::Term::Mode _term_mode;
+  // identifies the config file contents a cache was written for
+  struct Config_Key
+  {
+    std::int64_t mtime {0};
+    std::uint64_t size {0};
+    std::uint64_t hash {0};
+  };
+
+  static Config_Key config_key(fs::path const& path, std::string const& contents);
+
+  bool load_config_cache(fs::path const& path, Config_Key const& key);
+  void save_config_cache(fs::path const& path, Config_Key const& key);
+
+  // encode the settings, and decode them back, returns false if the
+  // snapshot is invalid and leaves the settings unchanged
+  std::string config_snapshot();
+  bool config_restore(std::string_view const buf);
+
+  // apply the groups of commands that changed since the config was last read,
+  // either all of them or none, returns true if a redraw is needed
+  bool reload_config();
+
+  // visit every setting stored in the config cache, in a fixed order
+  template<typename T>
+  void config_fields(T& io);
+
+  // the configured colour depth, or the one detected from the environment
+  OB::Color::Depth::Type colour_depth() const;
+
+  // the terminal is only opened when first needed
+  OB::Term::Mode& term_mode();
+
+  std::optional<OB::Term::Mode> _term_mode;
   bool const _colorterm;
   OB::Readline _readline;
   Peaclock _peaclock;
@@ -76,18 +138,79 @@ private:
     std::size_t width_min {4};
     std::size_t height_min {2};
 
-    // output buffer
-    std::ostringstream buf;
+    // no terminal attached
+    bool headless {false};
+
+    // load and save the binary config cache
+    bool config_cache {false};
+
+    // config file, its commands by group as last applied, and the watch
+    // that notices when it is edited
+    fs::path config_path;
+    std::unordered_map<std::string, std::vector<std::string>> config_groups;
+    OB::File_Watch config_watch;
+
+    // contents of the config when it was loaded from the cache,
+    // its groups are only built when the file is first reloaded
+    std::optional<std::string> config_contents;
+
+    // output of a frame, reused so that it only grows
+    OB::Buffer buf;
+
+    // cell framebuffer, only cells that changed since the last refresh are output
+    OB::Grid grid;
+
+    // the terminal supports synchronized output, each frame is then
+    // shown all at once instead of as it arrives
+    bool sync {false};
+
+    // the output is reduced to stay within the budget, and within what
+    // the terminal is measured to drain, so frames never queue behind it
+    struct Output
+    {
+      // bytes per second, 0 for no budget
+      OB::num rate {0, 0, 1000000000};
+      Throttle throttle {Peaclock::Reduce::fill + 1};
+
+      // when a frame that was skipped behind queued output is tried again
+      wall_clock::time_point retry;
+    } output;
+
+    // output colour depth in bits, 0 detects it from the environment
+    std::size_t colour_depth {0};
+
+    // frame instrumentation, only allocated while enabled
+    std::optional<Stats> stats;
 
     // control when to exit the event loop
     bool is_running {true};
 
-    // interval between reading a keypress
+    // no longer used, keys are read as soon as they arrive,
+    // kept so configs that set it still load
     OB::num input_interval {50, 10, 1000};
 
-    // total time spent in input loop
+    // interval between frames while a colour is animated
     OB::num refresh_rate {1000, 10, 60000};
 
+    // wall clock time of the current frame
+    wall_clock::time_point time;
+
+    // fires when the next frame is due
+    OB::Timer timer;
+
+    // resize and exit requests
+    OB::Signal signal;
+
+    // the terminal size is read before the next frame when a resize was
+    // signalled, with the frame delayed until a burst of resizes settles
+    struct Resize
+    {
+      bool pending {true};
+      wall_clock::time_point begin;
+      std::chrono::milliseconds settle {25};
+      std::chrono::milliseconds max {100};
+    } resize;
+
     // input key buffers
     OB::Text::Char32 key;
     std::vector<OB::Text::Char32> keys;
@@ -96,8 +219,7 @@ private:
     struct Prompt
     {
       std::string str;
-      int count {0};
-      int timeout {0};
+      wall_clock::time_point until;
       OB::num rate {5000, 0, 60000};
     } prompt;
 
@@ -114,12 +236,6 @@ private:
       OB::Color prompt_status {"", OB::Color::Type::fg};
     } style;
 
-    struct Regex
-    {
-      std::string const str_s {"(?:'[^'\\\\]*(?:\\\\.[^'\\\\]*)*')"};
-      std::string const str_d {"(?:\"[^\\\"\\\\]*(?:\\\\.[^\\\"\\\\]*)*\")"};
-      std::string const str {"(?:" + str_s + "|" + str_d + ")"};
-    } rx;
   } _ctx;
 };
 
@@ -0,0 +1,83 @@
+#include "ob/buffer.hh"
+#include "ob/grid.hh"
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <string>
+#include <iostream>
+#include <stdexcept>
+
+// number of failed checks
+static std::size_t failed {0};
+
+static void check(bool const val, std::string const& name)
+{
+  if (! val)
+  {
+    ++failed;
+    std::cerr << "fail: " << name << "\n";
+  }
+}
+
+static std::string rgb(std::size_t const fg, std::size_t const val)
+{
+  return "\x1b[" + std::string(fg ? "38" : "48") + ";2;" +
+    std::to_string(val % 256) + ";" + std::to_string((val / 256) % 256) + ";" +
+    std::to_string((val / 65536) % 256) + "m";
+}
+
+static void test_grid_style_max()
+{
+  // intern enough styles that the next clear starts the table over,
+  // then clear with a background that is not the default
+  OB::Grid grid;
+  grid.size(8, 2);
+
+  for (std::size_t i = 0; i < 5000; ++i)
+  {
+    grid.style(rgb(1, i));
+  }
+
+  auto const bg = rgb(0, 1);
+  grid.clear(bg);
+  grid.text(0, 0, "a", grid.style(rgb(1, 7)), grid.style(bg));
+
+  OB::Buffer buf;
+  grid.flush(buf);
+
+  bool valid {true};
+
+  for (std::size_t y = 0; y < grid.height(); ++y)
+  {
+    for (std::size_t x = 0; x < grid.width(); ++x)
+    {
+      try
+      {
+        valid = valid && grid.style(grid.at(x, y).bg) == bg;
+      }
+      catch (std::out_of_range const&)
+      {
+        valid = false;
+      }
+    }
+  }
+
+  check(valid, "grid clear past style_max keeps the background");
+  check(buf.view().find(bg) != std::string_view::npos,
+    "grid clear past style_max outputs the background");
+}
+
+int main()
+{
+  test_grid_style_max();
+
+  if (failed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "all tests passed\n";
+
+  return EXIT_SUCCESS;
+}